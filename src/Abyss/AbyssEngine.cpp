@@ -1,5 +1,6 @@
 #include "AbyssEngine.h"
 #include "Common/CommandLineOpts.h"
+#include "Common/PixelKernels.h"
 #include "FileSystem/CASC.h"
 #include "FileSystem/Direct.h"
 #include "FileSystem/MPQ.h"
@@ -23,7 +24,7 @@ namespace Abyss {
 
 AbyssEngine::AbyssEngine()
     : _running(true), _mouseOverGameWindow(false), _window(nullptr, SDL_DestroyWindow), _renderer(nullptr, SDL_DestroyRenderer),
-      _renderTexture(nullptr, SDL_DestroyTexture), _currentScene(nullptr), _nextScene(nullptr), _renderRect(), _locale("latin"), _lang("eng") {
+      _renderTexture(nullptr, Common::TextureTracker::destroy), _currentScene(nullptr), _nextScene(nullptr), _renderRect(), _locale("latin"), _lang("eng") {
     av_log_set_level(AV_LOG_FATAL);
 
     Singletons::setFileProvider(this);
@@ -34,6 +35,8 @@ AbyssEngine::AbyssEngine()
     Common::Log::Initialize();
     Common::Log::info("Abyss Engine");
     initializeSDL();
+    Common::Log::info("Using {} pixel kernels", Common::PixelKernels::getKernelName());
+    Common::Log::info("Using {} loader threads", _threadPool.getThreadCount());
     initializeImGui();
     initializeAudio();
     updateRenderRect();
@@ -51,6 +54,8 @@ AbyssEngine::~AbyssEngine() {
     _currentScene.reset(nullptr);
     _nextScene.reset(nullptr);
     _cursorImage = nullptr;
+    _uploadQueue.clear();
+    _spriteCache.clear();
     // -----------------------------------------------------------------------------
 
     ImGui_ImplSDLRenderer2_Shutdown();
@@ -69,6 +74,8 @@ void AbyssEngine::render() const {
     SDL_RenderClear(_renderer.get());
 
     ImGui::NewFrame();
+    Common::TextureTracker::beginFrame();
+    _spriteBatch->resetStats();
     if (_currentScene != nullptr) {
         SDL_SetRenderTarget(_renderer.get(), _renderTexture.get());
 
@@ -84,10 +91,13 @@ void AbyssEngine::render() const {
             }
         }
 
+        _spriteBatch->flush();
         SDL_SetRenderTarget(_renderer.get(), nullptr);
         SDL_RenderCopy(_renderer.get(), _renderTexture.get(), nullptr, &_renderRect);
     }
 
+    Common::TextureTracker::drawDebugWindow(_showTextureStats);
+
     ImGui::Render();
     ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData());
 
@@ -138,6 +148,9 @@ void AbyssEngine::processEvents(const std::chrono::duration<double> deltaTime) {
                 }
                 updateRenderRect();
             }
+
+            if (event.key.keysym.sym == SDLK_F9)
+                _showTextureStats = !_showTextureStats;
             break;
         case SDL_WINDOWEVENT:
             if (event.window.event == SDL_WINDOWEVENT_RESIZED) {
@@ -177,7 +190,9 @@ void AbyssEngine::initializeSDL() {
         throw std::runtime_error(absl::StrCat("SDL_CreateRenderer Error: ", SDL_GetError()));
     }
 
-    _renderTexture.reset(SDL_CreateTexture(_renderer.get(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 800, 600));
+    _renderTexture.reset(
+        Common::TextureTracker::createTexture(_renderer.get(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 800, 600, "AbyssEngine", "render target"));
+    _spriteBatch = std::make_unique<Common::SpriteBatch>(_renderer.get());
 }
 
 void AbyssEngine::initializeImGui() const {
@@ -286,6 +301,8 @@ void AbyssEngine::quit() { _running = false; }
 bool AbyssEngine::processCommandLineArguments(const int argc, char **argv) {
     bool quitOnRun = false;
     Common::CommandLineOpts::process(argc, argv, quitOnRun, _configuration);
+    Common::TextureTracker::setBudget(_configuration.getTextureBudget());
+    _decodeCache.setDirectory(_configuration.getCacheDir());
 
     return !quitOnRun;
 }
@@ -315,8 +332,10 @@ void AbyssEngine::run() {
         auto deltaTime = currentTime - lastTime;
         lastTime = currentTime;
         processEvents(deltaTime);
+        _uploadQueue.drain(std::chrono::milliseconds(4));
         render();
         processSceneChange();
+        _spriteCache.collect();
 
         if (_videoStream != nullptr && !_videoStream->getIsPlaying()) {
             _videoStream.reset(nullptr);
@@ -333,6 +352,14 @@ void AbyssEngine::setScene(std::unique_ptr<Common::Scene> scene) {
 
 Common::Configuration &AbyssEngine::getConfiguration() { return _configuration; }
 
+Common::SpriteCache &AbyssEngine::getSpriteCache() { return _spriteCache; }
+
+Common::UploadQueue &AbyssEngine::getUploadQueue() { return _uploadQueue; }
+
+Common::ThreadPool &AbyssEngine::getThreadPool() { return _threadPool; }
+
+const Common::DecodeCache &AbyssEngine::getDecodeCache() const { return _decodeCache; }
+
 void AbyssEngine::setBackgroundMusic(const std::string_view path) {
     _backgroundMusic = std::make_unique<Streams::AudioStream>(loadFile(path));
     _backgroundMusic->setLoop(true);
@@ -368,6 +395,8 @@ Common::MouseState &AbyssEngine::getMouseState() { return _mouseState; }
 
 SDL_Renderer *AbyssEngine::getRenderer() { return _renderer.get(); }
 
+Common::SpriteBatch &AbyssEngine::getSpriteBatch() { return *_spriteBatch; }
+
 void AbyssEngine::setWindowTitle(const std::string_view title) const { SDL_SetWindowTitle(_window.get(), title.data()); }
 
 void AbyssEngine::playVideo(const std::string_view path) { _videoStream = std::make_unique<Streams::VideoStream>(loadFile(path), std::nullopt); }
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "Common/Configuration.h"
+#include "Common/DecodeCache.h"
 #include "Common/Logging.h"
 #include "Common/MouseProvider.h"
 #include "Common/RendererProvider.h"
 #include "Common/Scene.h"
 #include "Common/SoundEffectProvider.h"
+#include "Common/SpriteBatch.h"
+#include "Common/SpriteCache.h"
+#include "Common/TextureTracker.h"
+#include "Common/ThreadPool.h"
+#include "Common/UploadQueue.h"
 #include "DataTypes/DC6.h"
 #include "FileSystem/FileLoader.h"
 #include "Singletons.h"
@@ -29,13 +35,18 @@ class AbyssEngine final : public FileSystem::FileLoader, public Common::Renderer
     std::unique_ptr<SDL_Window, decltype(&SDL_DestroyWindow)> _window;
     std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> _renderer;
     std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> _renderTexture;
+    std::unique_ptr<Common::SpriteBatch> _spriteBatch;
     std::unique_ptr<Common::Scene> _currentScene;
     std::unique_ptr<Common::Scene> _nextScene;
     std::unique_ptr<Streams::VideoStream> _videoStream;
     absl::flat_hash_map<std::string, std::unique_ptr<DataTypes::DC6>> _cursors;
+    Common::SpriteCache _spriteCache;
+    Common::UploadQueue _uploadQueue;
+    Common::DecodeCache _decodeCache;
     std::vector<Common::SoundEffectInterface *> _soundEffects;
     DataTypes::DC6 *_cursorImage{};
     SDL_Rect _renderRect;
+    mutable bool _showTextureStats{false};
     Common::MouseState _mouseState;
     std::unique_ptr<Streams::AudioStream> _backgroundMusic;
     std::string _locale;
@@ -48,6 +59,7 @@ class AbyssEngine final : public FileSystem::FileLoader, public Common::Renderer
     float _backgroundMusicAudioLevelActual = 1.0f;
     float _soundEffectsAudioLevel = 1.0f;
     float _soundEffectsAudioLevelActual = 1.0f;
+    Common::ThreadPool _threadPool; // Last, so the workers are joined before anything their jobs use is destroyed
 
     AbyssEngine();
     ~AbyssEngine() override;
@@ -68,6 +80,9 @@ class AbyssEngine final : public FileSystem::FileLoader, public Common::Renderer
     void run();
     void setScene(std::unique_ptr<Common::Scene> scene);
     [[nodiscard]] Common::Configuration &getConfiguration();
+    [[nodiscard]] Common::UploadQueue &getUploadQueue();
+    [[nodiscard]] Common::ThreadPool &getThreadPool();
+    [[nodiscard]] const Common::DecodeCache &getDecodeCache() const;
     void setBackgroundMusic(std::string_view path);
     void addCursorImage(std::string_view name, std::string_view path, const DataTypes::Palette &palette);
 
@@ -82,6 +97,8 @@ class AbyssEngine final : public FileSystem::FileLoader, public Common::Renderer
 
     // RendererProvider
     [[nodiscard]] SDL_Renderer *getRenderer() override;
+    [[nodiscard]] Common::SpriteBatch &getSpriteBatch() override;
+    [[nodiscard]] Common::SpriteCache &getSpriteCache() override;
     void setWindowTitle(std::string_view title) const;
     void playVideo(std::string_view path);
     void playVideoAndAudio(std::string_view videoPath, std::string_view audioPath);
@@ -1,6 +1,7 @@
 #include "CommandLineOpts.h"
 
 #include "Logging.h"
+#include <SDL2/SDL.h>
 #include <cxxopts.hpp>
 
 namespace Abyss::Common::CommandLineOpts {
@@ -11,7 +12,10 @@ void process(int argc, char **argv, bool &quitOnRun, Configuration &config) {
         ("d,mpqdir", "Path to MPQ files", cxxopts::value<std::string>()) //
         ("cascdir", "Path to CASC dir", cxxopts::value<std::string>()) //
         ("direct", "Path to dir", cxxopts::value<std::string>()) //
-        ("o,loadorder", "Comma separated list of MPQ files to load", cxxopts::value<std::string>())("h,help", "Print usage");
+        ("o,loadorder", "Comma separated list of MPQ files to load", cxxopts::value<std::string>()) //
+        ("texturebudget", "Warn when textures use more than this many MiB", cxxopts::value<size_t>()) //
+        ("cachedir", "Path to the decoded asset cache dir", cxxopts::value<std::string>()) //
+        ("nocache", "Disable the decoded asset cache")("h,help", "Print usage");
 
     auto result = options.parse(argc, argv);
 
@@ -60,6 +64,22 @@ void process(int argc, char **argv, bool &quitOnRun, Configuration &config) {
 #endif // _WIN32
     }
 
+    if (result.count("texturebudget") != 0U) {
+        const auto budget = result["texturebudget"].as<size_t>();
+        config.setTextureBudget(budget * 1024 * 1024);
+        Log::info("Texture budget: {} MiB", budget);
+    }
+
+    if (result.count("nocache") != 0U) {
+        Log::info("Decoded asset cache disabled");
+    } else if (result.count("cachedir") != 0U) {
+        config.setCacheDir(result["cachedir"].as<std::string>());
+        Log::info("Using cache directory: {}", config.getCacheDir().string());
+    } else if (auto *prefPath = SDL_GetPrefPath("OpenDiablo2", "AbyssEngine"); prefPath != nullptr) {
+        config.setCacheDir(std::filesystem::path(prefPath) / "cache");
+        SDL_free(prefPath);
+    }
+
     if (result.count("loadorder") == 0U) {
         Log::info("Using default MPQ load order");
     } else {
@@ -39,4 +39,12 @@ void Configuration::setMPQDir(std::filesystem::path newDir) {
     }
 }
 
+size_t Configuration::getTextureBudget() const { return _textureBudget; }
+
+void Configuration::setTextureBudget(const size_t bytes) { _textureBudget = bytes; }
+
+const std::filesystem::path &Configuration::getCacheDir() const { return _cacheDir; }
+
+void Configuration::setCacheDir(std::filesystem::path newDir) { _cacheDir = std::move(newDir); }
+
 } // namespace Abyss::Common
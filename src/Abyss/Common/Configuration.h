@@ -10,6 +10,8 @@ class Configuration {
     std::filesystem::path _mpqDir;
     std::filesystem::path _cascDir;
     std::vector<std::filesystem::path> _loadOrder;
+    size_t _textureBudget{};
+    std::filesystem::path _cacheDir;
 
   public:
     const std::vector<std::filesystem::path> &getLoadOrder();
@@ -20,6 +22,12 @@ class Configuration {
     void setDirectDir(std::filesystem::path newDir);
     void setMPQDir(std::filesystem::path newDir);
     void setCASCDir(std::filesystem::path newDir);
+    // Texture memory budget in bytes, 0 for none.
+    [[nodiscard]] size_t getTextureBudget() const;
+    void setTextureBudget(size_t bytes);
+    // Directory for the decoded asset cache, empty to disable it.
+    [[nodiscard]] const std::filesystem::path &getCacheDir() const;
+    void setCacheDir(std::filesystem::path newDir);
 };
 
 } // namespace Abyss::Common
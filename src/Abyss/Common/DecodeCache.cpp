@@ -0,0 +1,148 @@
+#include "DecodeCache.h"
+
+#include "Logging.h"
+
+#include <absl/strings/str_cat.h>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <system_error>
+#include <thread>
+
+namespace Abyss::Common {
+
+namespace {
+
+constexpr std::array<char, 4> Magic = {'A', 'B', 'D', 'C'};
+constexpr uint32_t FormatVersion = 1;
+
+struct EntryHeader {
+    std::array<char, 4> magic{};
+    uint32_t formatVersion{};
+    uint32_t decoderVersion{};
+    uint32_t pathLength{};
+    uint64_t sourceSize{};
+    uint64_t sourceHash{};
+    uint64_t payloadOffset{};
+    uint64_t payloadSize{};
+};
+
+} // namespace
+
+void DecodeCache::setDirectory(std::filesystem::path directory) {
+    std::error_code error;
+    if (!directory.empty() && !std::filesystem::create_directories(directory, error) && error) {
+        Log::warn("Decode cache disabled, cannot create {}: {}", directory.string(), error.message());
+        directory.clear();
+    }
+    _directory = std::move(directory);
+}
+
+bool DecodeCache::isEnabled() const { return !_directory.empty(); }
+
+std::filesystem::path DecodeCache::getEntryPath(const std::string_view assetPath, const std::string_view kind) const {
+    const auto pathHash = hashBytes(std::as_bytes(std::span(assetPath)));
+    return _directory / absl::StrCat(absl::Hex(pathHash, absl::kZeroPad16), ".", kind);
+}
+
+std::optional<std::vector<std::byte>> DecodeCache::load(const std::string_view assetPath, const std::string_view kind, const uint32_t decoderVersion,
+                                                        const std::span<const std::byte> source) const {
+    if (!isEnabled())
+        return std::nullopt;
+
+    return load(assetPath, kind, decoderVersion, source.size(), hashBytes(source));
+}
+
+std::optional<std::vector<std::byte>> DecodeCache::load(const std::string_view assetPath, const std::string_view kind, const uint32_t decoderVersion,
+                                                        const size_t sourceSize, const uint64_t sourceHash) const {
+    if (!isEnabled())
+        return std::nullopt;
+
+    std::ifstream file(getEntryPath(assetPath, kind), std::ios::binary);
+    if (!file)
+        return std::nullopt;
+
+    EntryHeader header;
+    if (!file.read(reinterpret_cast<char *>(&header), sizeof(header)))
+        return std::nullopt;
+
+    if (header.magic != Magic || header.formatVersion != FormatVersion || header.decoderVersion != decoderVersion ||
+        header.sourceSize != sourceSize || header.pathLength != assetPath.size())
+        return std::nullopt;
+
+    std::string storedPath(header.pathLength, '\0');
+    if (!file.read(storedPath.data(), header.pathLength) || storedPath != assetPath)
+        return std::nullopt;
+
+    if (header.sourceHash != sourceHash)
+        return std::nullopt;
+
+    std::vector<std::byte> payload(header.payloadSize);
+    if (!file.seekg(static_cast<std::streamoff>(header.payloadOffset)) ||
+        !file.read(reinterpret_cast<char *>(payload.data()), static_cast<std::streamsize>(payload.size())))
+        return std::nullopt;
+
+    return payload;
+}
+
+void DecodeCache::store(const std::string_view assetPath, const std::string_view kind, const uint32_t decoderVersion,
+                        const std::span<const std::byte> source, const std::span<const std::byte> payload) const {
+    if (!isEnabled())
+        return;
+
+    store(assetPath, kind, decoderVersion, source.size(), hashBytes(source), payload);
+}
+
+void DecodeCache::store(const std::string_view assetPath, const std::string_view kind, const uint32_t decoderVersion, const size_t sourceSize,
+                        const uint64_t sourceHash, const std::span<const std::byte> payload) const {
+    if (!isEnabled())
+        return;
+
+    EntryHeader header;
+    header.magic = Magic;
+    header.formatVersion = FormatVersion;
+    header.decoderVersion = decoderVersion;
+    header.pathLength = static_cast<uint32_t>(assetPath.size());
+    header.sourceSize = sourceSize;
+    header.sourceHash = sourceHash;
+    header.payloadOffset = (sizeof(header) + assetPath.size() + PayloadAlignment - 1) / PayloadAlignment * PayloadAlignment;
+    header.payloadSize = payload.size();
+
+    // Written under a unique name and renamed into place, so readers never see a partial entry.
+    const auto entryPath = getEntryPath(assetPath, kind);
+    auto temporaryPath = entryPath;
+    temporaryPath += absl::StrCat(".", std::hash<std::thread::id>{}(std::this_thread::get_id()), ".tmp");
+
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        const std::array<char, PayloadAlignment> padding{};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(assetPath.data(), static_cast<std::streamsize>(assetPath.size()));
+        file.write(padding.data(), static_cast<std::streamsize>(header.payloadOffset - sizeof(header) - assetPath.size()));
+        file.write(reinterpret_cast<const char *>(payload.data()), static_cast<std::streamsize>(payload.size()));
+        if (!file) {
+            Log::warn("Failed to write decode cache entry for {}", assetPath);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, entryPath, error);
+    if (error) {
+        Log::warn("Failed to write decode cache entry for {}: {}", assetPath, error.message());
+        std::filesystem::remove(temporaryPath, error);
+    }
+}
+
+uint64_t DecodeCache::hashBytes(const std::span<const std::byte> bytes) {
+    // FNV-1a; it must stay stable across runs, unlike absl::Hash.
+    uint64_t hash = 0xCBF29CE484222325;
+    for (const auto byte : bytes) {
+        hash ^= static_cast<uint8_t>(byte);
+        hash *= 0x100000001B3;
+    }
+    return hash;
+}
+
+} // namespace Abyss::Common
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace Abyss::Common {
+
+// Keeps decoded asset data on disk between runs. Each entry is a single file named after the asset path and holds the decoder's payload
+// behind a header recording the asset path, the size and hash of the source bytes and the decoder version, so changing the source data or
+// the decoder invalidates it automatically. Payloads are stored 16-byte aligned so they can be used in place. Safe to use from any thread;
+// with no directory set the cache is disabled.
+class DecodeCache {
+    std::filesystem::path _directory{};
+
+    [[nodiscard]] std::filesystem::path getEntryPath(std::string_view assetPath, std::string_view kind) const;
+
+  public:
+    static constexpr size_t PayloadAlignment = 16;
+
+    void setDirectory(std::filesystem::path directory);
+    [[nodiscard]] bool isEnabled() const;
+
+    [[nodiscard]] std::optional<std::vector<std::byte>> load(std::string_view assetPath, std::string_view kind, uint32_t decoderVersion,
+                                                             std::span<const std::byte> source) const;
+    void store(std::string_view assetPath, std::string_view kind, uint32_t decoderVersion, std::span<const std::byte> source,
+               std::span<const std::byte> payload) const;
+    // Same as above for callers that already hashed the source with hashBytes().
+    [[nodiscard]] std::optional<std::vector<std::byte>> load(std::string_view assetPath, std::string_view kind, uint32_t decoderVersion,
+                                                             size_t sourceSize, uint64_t sourceHash) const;
+    void store(std::string_view assetPath, std::string_view kind, uint32_t decoderVersion, size_t sourceSize, uint64_t sourceHash,
+               std::span<const std::byte> payload) const;
+
+    [[nodiscard]] static uint64_t hashBytes(std::span<const std::byte> bytes);
+};
+
+} // namespace Abyss::Common
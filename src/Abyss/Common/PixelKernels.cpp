@@ -0,0 +1,151 @@
+#include "PixelKernels.h"
+
+#include <SDL2/SDL.h>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define ABYSS_PIXEL_KERNELS_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define ABYSS_TARGET(isa) __attribute__((target(isa)))
+#else
+#define ABYSS_TARGET(isa)
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define ABYSS_PIXEL_KERNELS_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace Abyss::Common::PixelKernels {
+
+namespace {
+
+// Scalar kernel used on CPUs without a vector path. Fully transparent spans of eight pixels are detected with a single 64-bit load, which
+// keeps the large empty margins of sprites cheap.
+void expandGeneric(const uint8_t *indices, const uint8_t *mask, uint32_t *dest, const size_t count, const uint32_t *lookup) {
+    const auto *opacity = mask != nullptr ? mask : indices;
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, opacity + i, sizeof(word));
+        if (word == 0) {
+            std::memset(dest + i, 0, 8 * sizeof(uint32_t));
+            continue;
+        }
+
+        for (size_t j = i; j < i + 8; j++)
+            dest[j] = opacity[j] != 0 ? lookup[indices[j]] : 0;
+    }
+
+    for (; i < count; i++)
+        dest[i] = opacity[i] != 0 ? lookup[indices[i]] : 0;
+}
+
+#ifdef ABYSS_PIXEL_KERNELS_X86
+
+ABYSS_TARGET("avx2")
+void expandAvx2(const uint8_t *indices, const uint8_t *mask, uint32_t *dest, const size_t count, const uint32_t *lookup) {
+    const auto *opacity = mask != nullptr ? mask : indices;
+    const auto zero = _mm256_setzero_si256();
+    const auto *table = reinterpret_cast<const int *>(lookup);
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8) {
+        uint64_t opaqueWord;
+        std::memcpy(&opaqueWord, opacity + i, sizeof(opaqueWord));
+        if (opaqueWord == 0) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), zero);
+            continue;
+        }
+
+        const auto lanes = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(indices + i)));
+        const auto opaque = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(opacity + i)));
+        const auto texels = _mm256_i32gather_epi32(table, lanes, 4);
+        const auto transparent = _mm256_cmpeq_epi32(opaque, zero);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(dest + i), _mm256_andnot_si256(transparent, texels));
+    }
+
+    expandGeneric(indices + i, mask != nullptr ? mask + i : nullptr, dest + i, count - i, lookup);
+}
+
+#endif
+
+#ifdef ABYSS_PIXEL_KERNELS_NEON
+
+// AArch64 has no gather, but TBL looks up sixteen bytes at once in a 64 byte table. LD4 splits the lookup table into one byte plane per
+// channel, each plane is looked up in four 64 entry steps, and ST4 interleaves the channels back into texels.
+void expandNeon(const uint8_t *indices, const uint8_t *mask, uint32_t *dest, const size_t count, const uint32_t *lookup) {
+    const auto *opacity = mask != nullptr ? mask : indices;
+    const auto *lookupBytes = reinterpret_cast<const uint8_t *>(lookup);
+    uint8x16x4_t tables[4][4];
+    for (auto quarter = 0; quarter < 4; quarter++) {
+        for (auto slice = 0; slice < 4; slice++) {
+            const auto texels = vld4q_u8(lookupBytes + (quarter * 4 + slice) * 64);
+            for (auto channel = 0; channel < 4; channel++)
+                tables[channel][quarter].val[slice] = texels.val[channel];
+        }
+    }
+
+    const auto step = vdupq_n_u8(64);
+    size_t i = 0;
+
+    for (; i + 16 <= count; i += 16) {
+        const auto opaque = vld1q_u8(opacity + i);
+        if (vmaxvq_u8(opaque) == 0) {
+            std::memset(dest + i, 0, 16 * sizeof(uint32_t));
+            continue;
+        }
+
+        const auto keep = vtstq_u8(opaque, opaque);
+        const auto index0 = vld1q_u8(indices + i);
+        const auto index1 = vsubq_u8(index0, step);
+        const auto index2 = vsubq_u8(index1, step);
+        const auto index3 = vsubq_u8(index2, step);
+
+        uint8x16x4_t texels;
+        for (auto channel = 0; channel < 4; channel++) {
+            auto bytes = vqtbl4q_u8(tables[channel][0], index0);
+            bytes = vqtbx4q_u8(bytes, tables[channel][1], index1);
+            bytes = vqtbx4q_u8(bytes, tables[channel][2], index2);
+            bytes = vqtbx4q_u8(bytes, tables[channel][3], index3);
+            texels.val[channel] = vandq_u8(bytes, keep);
+        }
+        vst4q_u8(reinterpret_cast<uint8_t *>(dest + i), texels);
+    }
+
+    expandGeneric(indices + i, mask != nullptr ? mask + i : nullptr, dest + i, count - i, lookup);
+}
+
+#endif
+
+const std::vector<Kernel> &getKernels() {
+    static const std::vector<Kernel> kernels = [] {
+        std::vector<Kernel> supported{{expandGeneric, "Generic"}};
+#ifdef ABYSS_PIXEL_KERNELS_X86
+        if (SDL_HasAVX2())
+            supported.push_back({expandAvx2, "AVX2"});
+#endif
+#ifdef ABYSS_PIXEL_KERNELS_NEON
+        supported.push_back({expandNeon, "NEON"});
+#endif
+        return supported;
+    }();
+
+    return kernels;
+}
+
+} // namespace
+
+void expandIndexed(const uint8_t *indices, const uint8_t *mask, uint32_t *dest, const size_t count, const uint32_t *lookup) {
+    getKernels().back().expand(indices, mask, dest, count, lookup);
+}
+
+std::string_view getKernelName() { return getKernels().back().name; }
+
+std::span<const Kernel> getSupportedKernels() { return getKernels(); }
+
+} // namespace Abyss::Common::PixelKernels
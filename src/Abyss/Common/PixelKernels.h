@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+namespace Abyss::Common::PixelKernels {
+
+// Expands `count` palette indices into RGBA8888 texels through a 256 entry lookup table. When `mask` is null, index 0 is transparent;
+// otherwise a pixel is transparent when its mask byte is 0. The best kernel for the running CPU is picked on first use.
+void expandIndexed(const uint8_t *indices, const uint8_t *mask, uint32_t *dest, size_t count, const uint32_t *lookup);
+
+// Copies an opaque RLE run of palette indices and marks it opaque in the mask (when one is given).
+inline void copyRun(const void *source, uint8_t *indices, uint8_t *mask, const size_t count) {
+    std::memcpy(indices, source, count);
+    if (mask != nullptr)
+        std::memset(mask, 0xFF, count);
+}
+
+// Name of the kernel selected by the runtime dispatch, for logging.
+[[nodiscard]] std::string_view getKernelName();
+
+using ExpandKernel = void (*)(const uint8_t *indices, const uint8_t *mask, uint32_t *dest, size_t count, const uint32_t *lookup);
+
+struct Kernel {
+    ExpandKernel expand;
+    std::string_view name;
+};
+
+// Every expand kernel the running CPU supports, the generic one first and the one the dispatch picks last.
+[[nodiscard]] std::span<const Kernel> getSupportedKernels();
+
+} // namespace Abyss::Common::PixelKernels
@@ -4,10 +4,15 @@
 
 namespace Abyss::Common {
 
+class SpriteBatch;
+class SpriteCache;
+
 class RendererProvider {
   public:
     virtual ~RendererProvider() = default;
     [[nodiscard]] virtual auto getRenderer() -> SDL_Renderer * = 0;
+    [[nodiscard]] virtual auto getSpriteBatch() -> SpriteBatch & = 0;
+    [[nodiscard]] virtual auto getSpriteCache() -> SpriteCache & = 0;
 };
 
 } // namespace Abyss::Common
@@ -0,0 +1,75 @@
+#include "SpriteBatch.h"
+
+#include "TextureTracker.h"
+
+namespace Abyss::Common {
+
+SpriteBatch::SpriteBatch(SDL_Renderer *renderer) : _renderer(renderer) {}
+
+void SpriteBatch::draw(SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &dest) {
+    if (texture == nullptr)
+        return;
+
+    SDL_BlendMode blendMode;
+    SDL_GetTextureBlendMode(texture, &blendMode);
+
+    if (texture != _texture || blendMode != _blendMode) {
+        flush();
+
+        int width, height;
+        SDL_QueryTexture(texture, nullptr, nullptr, &width, &height);
+        _texture = texture;
+        _blendMode = blendMode;
+        TextureTracker::touch(texture);
+        _textureWidth = static_cast<float>(width);
+        _textureHeight = static_cast<float>(height);
+    }
+
+    SDL_Color color;
+    SDL_GetTextureColorMod(texture, &color.r, &color.g, &color.b);
+    SDL_GetTextureAlphaMod(texture, &color.a);
+
+    const auto u0 = source != nullptr ? static_cast<float>(source->x) / _textureWidth : 0.0f;
+    const auto v0 = source != nullptr ? static_cast<float>(source->y) / _textureHeight : 0.0f;
+    const auto u1 = source != nullptr ? static_cast<float>(source->x + source->w) / _textureWidth : 1.0f;
+    const auto v1 = source != nullptr ? static_cast<float>(source->y + source->h) / _textureHeight : 1.0f;
+
+    const auto x0 = static_cast<float>(dest.x);
+    const auto y0 = static_cast<float>(dest.y);
+    const auto x1 = static_cast<float>(dest.x + dest.w);
+    const auto y1 = static_cast<float>(dest.y + dest.h);
+
+    const auto base = static_cast<int>(_vertices.size());
+    _vertices.push_back({{x0, y0}, color, {u0, v0}});
+    _vertices.push_back({{x1, y0}, color, {u1, v0}});
+    _vertices.push_back({{x0, y1}, color, {u0, v1}});
+    _vertices.push_back({{x1, y1}, color, {u1, v1}});
+    _indices.insert(_indices.end(), {base, base + 1, base + 2, base + 2, base + 1, base + 3});
+    _quads++;
+}
+
+void SpriteBatch::flush() {
+    if (_vertices.empty())
+        return;
+
+    // The blend mode is applied when the geometry is submitted, so restore the one the quads were queued with.
+    SDL_SetTextureBlendMode(_texture, _blendMode);
+    SDL_RenderGeometry(_renderer, _texture, _vertices.data(), static_cast<int>(_vertices.size()), _indices.data(),
+                       static_cast<int>(_indices.size()));
+    _drawCalls++;
+
+    _vertices.clear();
+    _indices.clear();
+    _texture = nullptr;
+}
+
+size_t SpriteBatch::getDrawCalls() const { return _drawCalls; }
+
+size_t SpriteBatch::getQuads() const { return _quads; }
+
+void SpriteBatch::resetStats() {
+    _drawCalls = 0;
+    _quads = 0;
+}
+
+} // namespace Abyss::Common
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstddef>
+#include <vector>
+
+namespace Abyss::Common {
+
+// Collects textured quads and submits consecutive quads that share a texture and blend mode with a single SDL_RenderGeometry call.
+// Only runs of consecutive quads are merged, so draw order is exactly the order of the draw() calls.
+// Anything that changes renderer state (render target, clear, direct SDL_RenderCopy) must flush() first.
+class SpriteBatch {
+    SDL_Renderer *_renderer;
+    SDL_Texture *_texture{};
+    SDL_BlendMode _blendMode{SDL_BLENDMODE_NONE};
+    float _textureWidth{};
+    float _textureHeight{};
+    std::vector<SDL_Vertex> _vertices{};
+    std::vector<int> _indices{};
+    size_t _drawCalls{};
+    size_t _quads{};
+
+  public:
+    explicit SpriteBatch(SDL_Renderer *renderer);
+
+    // Queues `source` of `texture` (the whole texture when null) to be drawn at `dest`. The texture's current blend mode and color/alpha
+    // modulation are captured at call time.
+    void draw(SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &dest);
+    void flush();
+
+    // Draw call and quad counters since the last resetStats(), for profiling.
+    [[nodiscard]] size_t getDrawCalls() const;
+    [[nodiscard]] size_t getQuads() const;
+    void resetStats();
+};
+
+} // namespace Abyss::Common
@@ -0,0 +1,94 @@
+#include "SpriteCache.h"
+
+#include "Abyss/Singletons.h"
+
+#include <absl/strings/str_cat.h>
+#include <stdexcept>
+
+namespace Abyss::Common {
+
+std::shared_ptr<const DataTypes::DC6> SpriteCache::acquire(const std::string_view path, const DataTypes::Palette &palette,
+                                                           const Enums::BlendMode blendMode) {
+    const auto key = absl::StrCat(path, "|", palette.getName(), "|", static_cast<int>(blendMode));
+
+    if (const auto it = _entries.find(key); it != _entries.end()) {
+        it->second.released = false;
+        return it->second.sprite;
+    }
+
+    auto sprite = std::make_shared<DataTypes::DC6>(path, palette);
+    sprite->setBlendMode(blendMode);
+
+    return _entries.emplace(key, Entry{.sprite = std::move(sprite)}).first->second.sprite;
+}
+
+void SpriteCache::collect() {
+    const auto now = std::chrono::steady_clock::now();
+
+    absl::erase_if(_entries, [&](auto &item) {
+        auto &entry = item.second;
+        if (entry.sprite.use_count() > 1) {
+            entry.released = false;
+            return false;
+        }
+
+        if (!entry.released) {
+            entry.released = true;
+            entry.releasedAt = now;
+            return false;
+        }
+
+        return now - entry.releasedAt >= _gracePeriod;
+    });
+
+    for (auto &[key, entry] : _entries)
+        entry.sprite->evictUnused(_idleTime);
+}
+
+void SpriteCache::clear() { _entries.clear(); }
+
+void SpriteCache::setGracePeriod(const std::chrono::steady_clock::duration gracePeriod) { _gracePeriod = gracePeriod; }
+
+void SpriteCache::setIdleTime(const std::chrono::steady_clock::duration idleTime) { _idleTime = idleTime; }
+
+size_t SpriteCache::size() const { return _entries.size(); }
+
+CachedSprite::CachedSprite(const std::string_view path) : _path(path) {}
+
+CachedSprite::CachedSprite(const std::string_view path, const DataTypes::Palette &palette, const Enums::BlendMode blendMode)
+    : _path(path), _palette(palette), _blendMode(blendMode) {}
+
+const DataTypes::DC6 &CachedSprite::get() const {
+    if (!_sprite) {
+        if (!_palette)
+            throw std::runtime_error("CachedSprite has no palette set");
+
+        _sprite = Singletons::getRendererProvider().getSpriteCache().acquire(_path, *_palette, _blendMode);
+    }
+
+    return *_sprite;
+}
+
+void CachedSprite::setPalette(const DataTypes::Palette &palette) {
+    _palette = palette;
+    _sprite.reset();
+}
+
+void CachedSprite::setBlendMode(const Enums::BlendMode blendMode) {
+    _blendMode = blendMode;
+    _sprite.reset();
+}
+
+void CachedSprite::draw(const uint32_t frameIdx, const int x, const int y) const { get().draw(frameIdx, x, y); }
+
+void CachedSprite::draw(const uint32_t frameIdx, const int x, const int y, const int framesX, const int framesY) const {
+    get().draw(frameIdx, x, y, framesX, framesY);
+}
+
+uint32_t CachedSprite::getFrameCount() const { return get().getFrameCount(); }
+
+void CachedSprite::getFrameSize(const uint32_t frameIdx, int &frameWidth, int &frameHeight) const { get().getFrameSize(frameIdx, frameWidth, frameHeight); }
+
+void CachedSprite::getFrameOffset(const uint32_t frameIdx, int &offsetX, int &offsetY) const { get().getFrameOffset(frameIdx, offsetX, offsetY); }
+
+} // namespace Abyss::Common
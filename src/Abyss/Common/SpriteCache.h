@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Abyss/DataTypes/DC6.h"
+#include "Abyss/Enums/BlendMode.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Abyss::Common {
+
+// Shares decoded DC6 sprites between everything that draws the same (path, palette, blend mode), so identical sprites are decoded and
+// uploaded once. Entries are refcounted through the returned shared pointers; once the last user lets go, the sprite is kept around for a
+// grace period so that scenes which are torn down and rebuilt (e.g. MainMenu after Credits) pick it up again instead of reloading it.
+class SpriteCache {
+    struct Entry {
+        std::shared_ptr<DataTypes::DC6> sprite;
+        std::chrono::steady_clock::time_point releasedAt{};
+        bool released{false};
+    };
+
+    absl::flat_hash_map<std::string, Entry> _entries{};
+    std::chrono::steady_clock::duration _gracePeriod{std::chrono::seconds(30)};
+    std::chrono::steady_clock::duration _idleTime{std::chrono::seconds(10)};
+
+  public:
+    [[nodiscard]] std::shared_ptr<const DataTypes::DC6> acquire(std::string_view path, const DataTypes::Palette &palette, Enums::BlendMode blendMode);
+
+    // Evicts sprites that have had no users for longer than the grace period, and releases the directions and composites of the remaining
+    // sprites that have not been drawn for the idle time. Call once per frame.
+    void collect();
+    void clear();
+    void setGracePeriod(std::chrono::steady_clock::duration gracePeriod);
+    void setIdleTime(std::chrono::steady_clock::duration idleTime);
+    [[nodiscard]] size_t size() const;
+};
+
+// Drawable handle onto a sprite owned by the SpriteCache. The sprite is resolved on first use, so setting the palette and blend mode after
+// construction (as Button and Animation do) does not load intermediate variants.
+class CachedSprite {
+    std::string _path;
+    std::optional<DataTypes::Palette> _palette{};
+    Enums::BlendMode _blendMode{Enums::BlendMode::None};
+    mutable std::shared_ptr<const DataTypes::DC6> _sprite{};
+
+    const DataTypes::DC6 &get() const;
+
+  public:
+    explicit CachedSprite(std::string_view path);
+    CachedSprite(std::string_view path, const DataTypes::Palette &palette, Enums::BlendMode blendMode = Enums::BlendMode::None);
+
+    void setPalette(const DataTypes::Palette &palette);
+    void setBlendMode(Enums::BlendMode blendMode);
+    void draw(uint32_t frameIdx, int x, int y) const;
+    void draw(uint32_t frameIdx, int x, int y, int framesX, int framesY) const;
+    [[nodiscard]] uint32_t getFrameCount() const;
+    void getFrameSize(uint32_t frameIdx, int &frameWidth, int &frameHeight) const;
+    void getFrameOffset(uint32_t frameIdx, int &offsetX, int &offsetY) const;
+};
+
+typedef Animation<CachedSprite> CachedSpriteAnimation;
+
+} // namespace Abyss::Common
@@ -0,0 +1,241 @@
+#include "TextureTracker.h"
+
+#include "Logging.h"
+
+#include <algorithm>
+#include <imgui.h>
+#include <ranges>
+
+namespace Abyss::Common {
+
+namespace {
+
+size_t textureBytes(const Uint32 format, const int width, const int height) {
+    const auto pixels = static_cast<size_t>(width) * height;
+
+    switch (format) {
+    case SDL_PIXELFORMAT_IYUV:
+    case SDL_PIXELFORMAT_YV12:
+        return pixels + pixels / 2;
+    default:
+        return pixels * SDL_BYTESPERPIXEL(format);
+    }
+}
+
+} // namespace
+
+TextureTracker::State &TextureTracker::state() {
+    static auto *instance = new State;
+    return *instance;
+}
+
+void TextureTracker::checkBudget(State &state) {
+    if (state.budgetBytes == 0)
+        return;
+
+    const auto overBudget = state.totals.bytes > state.budgetBytes;
+    if (overBudget && !state.overBudget)
+        Log::warn("Texture memory over budget: {} KiB used, {} KiB budget ({} textures)", state.totals.bytes / 1024, state.budgetBytes / 1024,
+                  state.totals.count);
+
+    state.overBudget = overBudget;
+}
+
+SDL_Texture *TextureTracker::createTexture(SDL_Renderer *renderer, const Uint32 format, const int access, const int width, const int height,
+                                           const std::string_view owner, const std::string_view path) {
+    auto *texture = SDL_CreateTexture(renderer, format, access, width, height);
+    if (texture == nullptr)
+        return nullptr;
+
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+
+    const auto bytes = textureBytes(format, width, height);
+    tracker.records[texture] = TextureRecord{.texture = texture,
+                                             .owner = std::string(owner),
+                                             .path = std::string(path),
+                                             .width = width,
+                                             .height = height,
+                                             .bytes = bytes,
+                                             .lastUsedFrame = tracker.frame};
+    tracker.totals.count++;
+    tracker.totals.bytes += bytes;
+    checkBudget(tracker);
+
+    return texture;
+}
+
+void TextureTracker::destroy(SDL_Texture *texture) {
+    if (texture == nullptr)
+        return;
+
+    {
+        auto &tracker = state();
+        std::lock_guard lock(tracker.mutex);
+
+        if (const auto it = tracker.records.find(texture); it != tracker.records.end()) {
+            tracker.totals.count--;
+            tracker.totals.bytes -= it->second.bytes;
+            tracker.records.erase(it);
+            checkBudget(tracker);
+        }
+    }
+
+    SDL_DestroyTexture(texture);
+}
+
+void TextureTracker::touch(SDL_Texture *texture) {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+
+    if (const auto it = tracker.records.find(texture); it != tracker.records.end())
+        it->second.lastUsedFrame = tracker.frame;
+}
+
+void TextureTracker::beginFrame() {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+    tracker.frame++;
+}
+
+uint64_t TextureTracker::getFrame() {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+    return tracker.frame;
+}
+
+void TextureTracker::setBudget(const size_t bytes) {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+    tracker.budgetBytes = bytes;
+    tracker.overBudget = false;
+    checkBudget(tracker);
+}
+
+size_t TextureTracker::getBudget() {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+    return tracker.budgetBytes;
+}
+
+TextureTotals TextureTracker::getTotals() {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+    return tracker.totals;
+}
+
+absl::flat_hash_map<std::string, TextureTotals> TextureTracker::getTotalsByOwner() {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+
+    absl::flat_hash_map<std::string, TextureTotals> result;
+    for (const auto &record : tracker.records | std::views::values) {
+        auto &totals = result[record.owner];
+        totals.count++;
+        totals.bytes += record.bytes;
+    }
+
+    return result;
+}
+
+std::vector<TextureRecord> TextureTracker::getLargest(const size_t count) {
+    std::vector<TextureRecord> result;
+    {
+        auto &tracker = state();
+        std::lock_guard lock(tracker.mutex);
+        result.reserve(tracker.records.size());
+        for (const auto &record : tracker.records | std::views::values)
+            result.push_back(record);
+    }
+
+    const auto resultCount = std::min(count, result.size());
+    std::ranges::partial_sort(result, result.begin() + static_cast<std::ptrdiff_t>(resultCount),
+                              [](const auto &a, const auto &b) { return a.bytes > b.bytes; });
+    result.resize(resultCount);
+
+    return result;
+}
+
+std::vector<TextureRecord> TextureTracker::getUnusedFor(const uint64_t frames) {
+    auto &tracker = state();
+    std::lock_guard lock(tracker.mutex);
+
+    std::vector<TextureRecord> result;
+    for (const auto &record : tracker.records | std::views::values) {
+        if (tracker.frame - record.lastUsedFrame >= frames)
+            result.push_back(record);
+    }
+
+    return result;
+}
+
+void TextureTracker::drawDebugWindow(bool &open) {
+    static int topCount = 20;
+
+    if (!open)
+        return;
+
+    ImGui::SetNextWindowSize(ImVec2(600, 400), ImGuiCond_FirstUseEver);
+    if (!ImGui::Begin("Textures", &open)) {
+        ImGui::End();
+        return;
+    }
+
+    const auto totals = getTotals();
+    const auto budget = getBudget();
+    const auto frame = getFrame();
+
+    ImGui::Text("%zu textures, %.2f MiB", totals.count, static_cast<double>(totals.bytes) / (1024.0 * 1024.0));
+    if (budget != 0)
+        ImGui::Text("Budget: %.2f MiB (%.0f%%)", static_cast<double>(budget) / (1024.0 * 1024.0),
+                    100.0 * static_cast<double>(totals.bytes) / static_cast<double>(budget));
+
+    if (ImGui::BeginTable("Owners", 3, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        ImGui::TableSetupColumn("Owner");
+        ImGui::TableSetupColumn("Textures");
+        ImGui::TableSetupColumn("KiB");
+        ImGui::TableHeadersRow();
+
+        for (const auto &[owner, ownerTotals] : getTotalsByOwner()) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(owner.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", ownerTotals.count);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", ownerTotals.bytes / 1024);
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::Separator();
+    ImGui::SliderInt("Top", &topCount, 1, 200);
+
+    if (ImGui::BeginTable("Largest", 5, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY)) {
+        ImGui::TableSetupColumn("Owner");
+        ImGui::TableSetupColumn("Path");
+        ImGui::TableSetupColumn("Size");
+        ImGui::TableSetupColumn("KiB");
+        ImGui::TableSetupColumn("Idle frames");
+        ImGui::TableHeadersRow();
+
+        for (const auto &record : getLargest(static_cast<size_t>(topCount))) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(record.owner.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(record.path.c_str());
+            ImGui::TableNextColumn();
+            ImGui::Text("%dx%d", record.width, record.height);
+            ImGui::TableNextColumn();
+            ImGui::Text("%zu", record.bytes / 1024);
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(frame - record.lastUsedFrame));
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
+} // namespace Abyss::Common
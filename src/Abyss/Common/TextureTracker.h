@@ -0,0 +1,69 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <absl/container/flat_hash_map.h>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Abyss::Common {
+
+struct TextureRecord {
+    SDL_Texture *texture{};
+    std::string owner{};
+    std::string path{};
+    int width{};
+    int height{};
+    size_t bytes{};
+    uint64_t lastUsedFrame{};
+};
+
+struct TextureTotals {
+    size_t count{};
+    size_t bytes{};
+};
+
+// Accounts for every texture the engine creates. Textures are created through createTexture() and released through destroy(), which has
+// the same signature as SDL_DestroyTexture so it can be used as the deleter of the usual unique_ptr<SDL_Texture, ...> members.
+class TextureTracker {
+    struct State {
+        std::mutex mutex{};
+        absl::flat_hash_map<SDL_Texture *, TextureRecord> records{};
+        TextureTotals totals{};
+        uint64_t frame{};
+        size_t budgetBytes{};
+        bool overBudget{};
+    };
+
+    // Never destroyed: textures owned by other statics (the engine itself) are released during static destruction.
+    static State &state();
+    static void checkBudget(State &state);
+
+  public:
+    [[nodiscard]] static SDL_Texture *createTexture(SDL_Renderer *renderer, Uint32 format, int access, int width, int height, std::string_view owner,
+                                                    std::string_view path);
+    static void destroy(SDL_Texture *texture);
+
+    // Marks a texture as used in the current frame.
+    static void touch(SDL_Texture *texture);
+    static void beginFrame();
+    [[nodiscard]] static uint64_t getFrame();
+
+    // Logs a warning whenever the total crosses the budget. 0 disables the check.
+    static void setBudget(size_t bytes);
+    [[nodiscard]] static size_t getBudget();
+
+    [[nodiscard]] static TextureTotals getTotals();
+    [[nodiscard]] static absl::flat_hash_map<std::string, TextureTotals> getTotalsByOwner();
+    // Largest textures first.
+    [[nodiscard]] static std::vector<TextureRecord> getLargest(size_t count);
+    // Textures not drawn during the last `frames` frames.
+    [[nodiscard]] static std::vector<TextureRecord> getUnusedFor(uint64_t frames);
+
+    static void drawDebugWindow(bool &open);
+};
+
+} // namespace Abyss::Common
@@ -0,0 +1,57 @@
+#include "ThreadPool.h"
+
+namespace Abyss::Common {
+
+ThreadPool::ThreadPool(const unsigned threadCount) {
+    _threads.reserve(threadCount);
+    for (auto i = 0u; i < threadCount; i++)
+        _threads.emplace_back([this] { workerLoop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(_mutex);
+        _stopping = true;
+        _jobs.clear();
+    }
+    _condition.notify_all();
+
+    for (auto &thread : _threads)
+        thread.join();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock lock(_mutex);
+            _condition.wait(lock, [this] { return _stopping || !_jobs.empty(); });
+            if (_stopping)
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        job();
+    }
+}
+
+bool ThreadPool::runOne() {
+    std::function<void()> job;
+    {
+        std::lock_guard lock(_mutex);
+        if (_jobs.empty())
+            return false;
+
+        job = std::move(_jobs.front());
+        _jobs.pop_front();
+    }
+
+    job();
+    return true;
+}
+
+size_t ThreadPool::getThreadCount() const { return _threads.size(); }
+
+} // namespace Abyss::Common
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Abyss::Common {
+
+// A fixed set of worker threads for CPU-bound loading work, so nested parallel loads (files, then tiles within a file) share the cores
+// instead of each spawning their own threads. Jobs that wait on other jobs must use wait(), which keeps running queued work in the meantime
+// so a saturated pool cannot deadlock on itself.
+class ThreadPool {
+    std::vector<std::thread> _threads{};
+    std::deque<std::function<void()>> _jobs{};
+    std::mutex _mutex{};
+    std::condition_variable _condition{};
+    bool _stopping{false};
+
+    void workerLoop();
+    bool runOne();
+
+  public:
+    explicit ThreadPool(unsigned threadCount = std::max(1u, std::thread::hardware_concurrency()));
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    template <typename Function> auto submit(Function &&function) -> std::future<std::invoke_result_t<std::decay_t<Function>>> {
+        using Result = std::invoke_result_t<std::decay_t<Function>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        auto future = task->get_future();
+        {
+            std::lock_guard lock(_mutex);
+            _jobs.emplace_back([task] { (*task)(); });
+        }
+        _condition.notify_one();
+        return future;
+    }
+
+    template <typename Result> Result wait(std::future<Result> &future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (!runOne())
+                future.wait_for(std::chrono::milliseconds(1));
+        }
+        return future.get();
+    }
+
+    [[nodiscard]] size_t getThreadCount() const;
+};
+
+} // namespace Abyss::Common
@@ -0,0 +1,38 @@
+#include "UploadQueue.h"
+
+namespace Abyss::Common {
+
+void UploadQueue::push(std::function<void()> job) {
+    std::lock_guard lock(_mutex);
+    _jobs.push_back(std::move(job));
+}
+
+void UploadQueue::drain(const std::chrono::steady_clock::duration budget) {
+    const auto deadline = std::chrono::steady_clock::now() + budget;
+
+    do {
+        std::function<void()> job;
+        {
+            std::lock_guard lock(_mutex);
+            if (_jobs.empty())
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+        }
+
+        job();
+    } while (std::chrono::steady_clock::now() < deadline);
+}
+
+void UploadQueue::clear() {
+    std::lock_guard lock(_mutex);
+    _jobs.clear();
+}
+
+size_t UploadQueue::size() const {
+    std::lock_guard lock(_mutex);
+    return _jobs.size();
+}
+
+} // namespace Abyss::Common
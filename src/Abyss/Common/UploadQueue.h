@@ -0,0 +1,25 @@
+#pragma once
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace Abyss::Common {
+
+// Texture uploads produced by worker threads. Jobs may be pushed from any thread, but they run on the render thread, which drains the
+// queue once per frame within a time budget so large loads are spread over several frames instead of stalling one.
+class UploadQueue {
+    std::deque<std::function<void()>> _jobs{};
+    mutable std::mutex _mutex{};
+
+  public:
+    void push(std::function<void()> job);
+
+    // Runs queued jobs until the budget is spent. At least one job runs per call so the queue always makes progress.
+    void drain(std::chrono::steady_clock::duration budget);
+    void clear();
+    [[nodiscard]] size_t size() const;
+};
+
+} // namespace Abyss::Common
@@ -1,6 +1,10 @@
+#include <algorithm>
 #include <cstring>
+#include <limits>
 
-#include "Abyss/Streams/StreamReader.h"
+#include "Abyss/Common/PixelKernels.h"
+#include "Abyss/Common/SpriteBatch.h"
+#include "Abyss/Streams/SpanReader.h"
 #include "DC6.h"
 
 #include "Abyss/Singletons.h"
@@ -8,9 +12,9 @@
 namespace Abyss::DataTypes {
 
 DC6::DC6(const std::string_view path)
-    : _version(0), _flags(0), _encoding(0), _directions(0), _framesPerDirection(0), _texture(nullptr, &SDL_DestroyTexture), _blendMode(Enums::BlendMode::None) {
-    auto stream = Singletons::getFileProvider().loadFile(path);
-    Streams::StreamReader sr(stream);
+    : _path(path), _version(0), _flags(0), _encoding(0), _directions(0), _framesPerDirection(0), _blendMode(Enums::BlendMode::None) {
+    _fileData = Singletons::getFileProvider().loadBytes(path);
+    Streams::SpanReader sr(_fileData);
     _version = sr.readUInt32();
     _flags = sr.readUInt32();
     _encoding = sr.readUInt32();
@@ -26,9 +30,12 @@ DC6::DC6(const std::string_view path)
       framePointer = sr.readUInt32();
     }
 
+    _frames.reserve(frameCount);
     for ([[maybe_unused]] auto &framePointer : _framePointers) {
         _frames.emplace_back(sr);
     }
+
+    _directionCache.resize(_directions);
 }
 
 DC6::DC6(const std::string_view path, const Palette &palette) : DC6(path) { setPalette(palette); }
@@ -41,6 +48,16 @@ uint32_t DC6::getFramesPerDirection() const { return _framesPerDirection; }
 std::vector<uint32_t> DC6::getFramePointers() const { return _framePointers; }
 uint32_t DC6::getFrameCount() const { return _framesPerDirection; }
 void DC6::setPalette(const Palette &palette) {
+    _palette = palette;
+    _composites.clear();
+
+    // Directions decoded so far keep their indexed frames, so only the palette expansion has to run again.
+    for (auto &direction : _directionCache) {
+        if (direction.texture)
+            uploadDirection(direction);
+    }
+}
+IndexedImage DC6::decodeFrame(const DC6Frame &frame) {
     enum class eScanlineType { EndOfLine, RunOfTransparentPixels, RunOfOpaquePixels };
     auto scanlineType = [](const std::byte b) -> eScanlineType {
         if (b == DC6EndOfScanline)
@@ -52,125 +69,349 @@ void DC6::setPalette(const Palette &palette) {
         return eScanlineType::RunOfOpaquePixels;
     };
 
+    IndexedImage image(static_cast<int>(frame.getWidth()), static_cast<int>(frame.getHeight()), true);
+
+    if (image.empty())
+        return image;
+
+    auto process = true;
+    auto x = 0;
+    auto y = frame.getHeight() - 1;
+    auto offset = 0;
+
+    const auto frameData = frame.getFrameData();
+    while (process) {
+        const auto b = frameData[offset];
+        offset++;
+
+        switch (scanlineType(b)) {
+        case eScanlineType::EndOfLine: {
+            if (y == 0) {
+                process = false;
+                break;
+            }
+            y--;
+            x = 0;
+            break;
+        }
+        case eScanlineType::RunOfTransparentPixels: {
+            const auto &transparentPixels = b & DC6MaxRunLength;
+            x += static_cast<int>(transparentPixels);
+            break;
+        }
+        case eScanlineType::RunOfOpaquePixels: {
+            const auto pixelOffset = y * image.width + x;
+            const auto runLength = static_cast<int>(b);
+            Common::PixelKernels::copyRun(&frameData[offset], &image.indices[pixelOffset], &image.mask[pixelOffset], runLength);
+            offset += runLength;
+            x += runLength;
+            break;
+        }
+        }
+    }
+
+    return image;
+}
+void DC6::decodeDirection(const uint32_t direction) const {
+    if (!_palette)
+        throw std::runtime_error("DC6 has no palette set");
+
+    auto &cache = _directionCache[direction];
+    const auto firstFrame = _frames.begin() + direction * _framesPerDirection;
+    const auto lastFrame = firstFrame + _framesPerDirection;
+
     uint32_t textureWidth = 1;
     uint32_t textureHeight = 1;
 
-    for (const auto &frame : _frames) {
-        textureWidth += frame.getWidth();
-        textureHeight = std::max(textureHeight, frame.getHeight());
+    cache.frames.clear();
+    cache.frames.reserve(_framesPerDirection);
+    cache.frameRects.clear();
+    cache.frameRects.reserve(_framesPerDirection);
+
+    // Frames are trimmed to their opaque bounds, so the texture only holds visible pixels. draw() adds the trim offset back. With
+    // BlendMode::None the transparent border is part of what gets drawn, so those frames are kept whole.
+    const auto trimFrames = _blendMode != Enums::BlendMode::None;
+    for (auto frame = firstFrame; frame != lastFrame; ++frame) {
+        auto &image = cache.frames.emplace_back(decodeFrame(*frame));
+        if (trimFrames)
+            image.trim();
+        cache.frameRects.emplace_back(SDL_Rect{static_cast<int>(textureWidth) - 1, 0, image.width, image.height});
+        textureWidth += image.width;
+        textureHeight = std::max(textureHeight, static_cast<uint32_t>(image.height));
     }
 
-    _texture.reset(SDL_CreateTexture(Singletons::getRendererProvider().getRenderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
-                                     static_cast<int>(textureWidth), static_cast<int>(textureHeight)));
+    cache.texture.reset(Common::TextureTracker::createTexture(Singletons::getRendererProvider().getRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                                                              SDL_TEXTUREACCESS_STREAMING, static_cast<int>(textureWidth), static_cast<int>(textureHeight),
+                                                              "DC6", _path));
 
-    if (!_texture)
+    if (!cache.texture)
         throw std::runtime_error(SDL_GetError());
 
+    uploadDirection(cache);
+    applyBlendMode(cache.texture.get());
+}
+void DC6::uploadDirection(DC6Direction &direction) const {
     void *pixels;
     int pitch;
-    if (SDL_LockTexture(_texture.get(), nullptr, &pixels, &pitch))
+    if (SDL_LockTexture(direction.texture.get(), nullptr, &pixels, &pitch))
         throw std::runtime_error(SDL_GetError());
 
+    int textureHeight;
+    SDL_QueryTexture(direction.texture.get(), nullptr, nullptr, nullptr, &textureHeight);
     std::memset(pixels, 0, textureHeight * pitch);
 
-    auto originX = 0;
-    for (const auto &frame : _frames) {
-        auto process = true;
-        auto x = originX;
-        auto y = frame.getHeight() - 1;
-        auto offset = 0;
-
-        const auto &frameData = frame.getFrameData();
-        while (process) {
-            const auto b = frameData[offset];
-            offset++;
-
-            switch (scanlineType(b)) {
-            case eScanlineType::EndOfLine: {
-                if (y == 0) {
-                    process = false;
-                    break;
-                }
-                y--;
-                x = originX;
-                break;
-            }
-            case eScanlineType::RunOfTransparentPixels: {
-                const auto &transparentPixels = b & DC6MaxRunLength;
-                x += static_cast<int>(transparentPixels);
-                break;
-            }
-            case eScanlineType::RunOfOpaquePixels: {
-                for (auto i = 0; i < static_cast<int>(b); i++) {
-                    const auto paletteIndex = static_cast<int>(frameData[offset]);
-                    const auto &paletteColor = palette.getEntries()[paletteIndex];
-                    const auto pixel = static_cast<uint32_t>(paletteColor.getBlue() << 24 | paletteColor.getGreen() << 16 | paletteColor.getRed() << 8 | 0xFF);
-                    *(static_cast<uint32_t *>(pixels) + y * (pitch / 4) + x + i) = pixel;
-
-                    offset++;
-                }
-                x += static_cast<int>(b);
-                break;
-            }
-            }
-        }
+    for (auto i = 0; i < static_cast<int>(direction.frames.size()); i++)
+        direction.frames[i].expand(*_palette, static_cast<uint32_t *>(pixels) + direction.frameRects[i].x, pitch);
+
+    SDL_UnlockTexture(direction.texture.get());
+}
+const DC6Direction &DC6::getDirection(const uint32_t frameIdx) const {
+    if (frameIdx >= _frames.size())
+        throw std::runtime_error("Invalid frame index");
 
-        _frameRects.emplace_back(SDL_Rect{originX, 0, static_cast<int>(frame.getWidth()), static_cast<int>(frame.getHeight())});
-        originX += static_cast<int>(frame.getWidth());
+    const auto direction = frameIdx / _framesPerDirection;
+    auto &cache = _directionCache[direction];
+    if (!cache.texture)
+        decodeDirection(direction);
+
+    cache.lastUsed = std::chrono::steady_clock::now();
+    return cache;
+}
+void DC6::prefetch(const uint32_t direction) const {
+    if (direction >= _directions)
+        throw std::runtime_error("Invalid direction index");
+
+    getDirection(direction * _framesPerDirection);
+}
+size_t DC6::evictUnused(const std::chrono::steady_clock::duration maxIdle) {
+    const auto now = std::chrono::steady_clock::now();
+    size_t evicted = 0;
+
+    for (auto &cache : _directionCache) {
+        if (!cache.texture || now - cache.lastUsed < maxIdle)
+            continue;
+
+        cache.texture.reset();
+        cache.frameRects.clear();
+        cache.frames.clear();
+        evicted++;
     }
 
-    SDL_UnlockTexture(_texture.get());
-    setBlendMode(_blendMode);
+    evicted += std::erase_if(_composites, [&](const auto &composite) { return now - composite.lastUsed >= maxIdle; });
+
+    return evicted;
 }
+bool DC6::isDirectionDecoded(const uint32_t direction) const { return direction < _directionCache.size() && _directionCache[direction].texture; }
 void DC6::draw(const uint32_t frameIdx, const int x, const int y) const {
-    if (frameIdx >= _frameRects.size())
-        throw std::runtime_error("Invalid frame index");
+    const auto &direction = getDirection(frameIdx);
+    const auto &frameRect = direction.frameRects[frameIdx % _framesPerDirection];
+    if (frameRect.w == 0)
+        return;
 
-    const auto &frameRect = _frameRects[frameIdx];
+    const auto &image = direction.frames[frameIdx % _framesPerDirection];
     const auto &frame = _frames[frameIdx];
-    const SDL_Rect destRect{x + frame.getXOffset(), y + frame.getYOffset() - frameRect.h, frameRect.w, frameRect.h};
-    SDL_RenderCopy(Singletons::getRendererProvider().getRenderer(), _texture.get(), &frameRect, &destRect);
+    const SDL_Rect destRect{x + frame.getXOffset() + image.offsetX, y + frame.getYOffset() - static_cast<int>(frame.getHeight()) + image.offsetY, frameRect.w,
+                            frameRect.h};
+    Singletons::getRendererProvider().getSpriteBatch().draw(direction.texture.get(), &frameRect, destRect);
+}
+void DC6::draw(const uint32_t frameIdx, const int x, const int y, const int framesX, const int framesY) const {
+    const auto &composite = getComposite(frameIdx, framesX, framesY);
+    const SDL_Rect destRect{x + composite.bounds.x, y + composite.bounds.y, composite.bounds.w, composite.bounds.h};
+    Singletons::getRendererProvider().getSpriteBatch().draw(composite.texture.get(), nullptr, destRect);
 }
-void DC6::draw(uint32_t frameIdx, const int x, int y, const int framesX, const int framesY) const {
+std::vector<uint32_t> DC6::composeFrames(uint32_t frameIdx, const int framesX, const int framesY, SDL_Rect &bounds) const {
+    if (!_palette)
+        throw std::runtime_error("DC6 has no palette set");
+
+    if (framesX <= 0 || framesY <= 0 || frameIdx + framesX * framesY > _frames.size())
+        throw std::runtime_error("Invalid frame index");
+
+    struct Placement {
+        uint32_t frameIdx;
+        int x;
+        int y;
+    };
+
+    // Same layout as drawing the grid frame by frame: each row advances by the size of its first frame.
+    std::vector<Placement> placements;
+    placements.reserve(framesX * framesY);
+    auto minX = std::numeric_limits<int>::max();
+    auto minY = std::numeric_limits<int>::max();
+    auto maxX = std::numeric_limits<int>::min();
+    auto maxY = std::numeric_limits<int>::min();
+    auto y = 0;
+
     for (auto fy = 0; fy < framesY; fy++) {
-        auto orgX = x;
-        const auto yAdjust = _frameRects[frameIdx].h;
-        const auto xAdjust = _frameRects[frameIdx].w;
+        auto orgX = 0;
+        int xAdjust;
+        int yAdjust;
+        getFrameSize(frameIdx, xAdjust, yAdjust);
         for (auto fx = 0; fx < framesX; fx++) {
-            draw(frameIdx, orgX, y + yAdjust);
+            const auto &frame = _frames[frameIdx];
+            const auto width = static_cast<int>(frame.getWidth());
+            const auto height = static_cast<int>(frame.getHeight());
+            const auto frameX = orgX + frame.getXOffset();
+            const auto frameY = y + yAdjust + frame.getYOffset() - height;
+
+            placements.push_back({frameIdx, frameX, frameY});
+            minX = std::min(minX, frameX);
+            minY = std::min(minY, frameY);
+            maxX = std::max(maxX, frameX + width);
+            maxY = std::max(maxY, frameY + height);
+
             frameIdx++;
             orgX += xAdjust;
         }
         y += yAdjust;
     }
+
+    bounds = {minX, minY, std::max(maxX - minX, 1), std::max(maxY - minY, 1)};
+    std::vector<uint32_t> pixels(static_cast<size_t>(bounds.w) * bounds.h);
+    std::vector<uint32_t> scratch;
+    IndexedImage decoded;
+
+    // BlendMode::None draws every frame as an opaque rectangle, with transparent pixels in black. The composite reproduces that inside each
+    // frame and leaves the gaps between frames transparent, so getComposite() blends it.
+    const auto opaqueFrames = _blendMode == Enums::BlendMode::None;
+    constexpr uint32_t OpaqueBlack = 0xFF;
+
+    for (const auto &[placedFrame, frameX, frameY] : placements) {
+        const auto &frame = _frames[placedFrame];
+        if (opaqueFrames) {
+            for (auto row = 0; row < static_cast<int>(frame.getHeight()); row++) {
+                auto *dest = pixels.data() + static_cast<size_t>(frameY - bounds.y + row) * bounds.w + (frameX - bounds.x);
+                std::fill_n(dest, frame.getWidth(), OpaqueBlack);
+            }
+        }
+
+        // Frames of a decoded direction are already in the cache; the others are decoded from the file data.
+        const auto &direction = _directionCache[placedFrame / _framesPerDirection];
+        const auto cached = direction.texture != nullptr;
+        if (!cached)
+            decoded = decodeFrame(frame);
+
+        const auto &image = cached ? direction.frames[placedFrame % _framesPerDirection] : decoded;
+        if (image.empty())
+            continue;
+
+        scratch.resize(image.indices.size());
+        image.expand(*_palette, scratch.data(), image.width * static_cast<int>(sizeof(uint32_t)));
+
+        // Later frames are drawn over earlier ones, so only their opaque pixels are copied.
+        const auto imageX = frameX + image.offsetX - bounds.x;
+        const auto imageY = frameY + image.offsetY - bounds.y;
+        for (auto row = 0; row < image.height; row++) {
+            const auto srcOffset = static_cast<size_t>(row) * image.width;
+            auto *dest = pixels.data() + static_cast<size_t>(imageY + row) * bounds.w + imageX;
+            for (auto col = 0; col < image.width; col++) {
+                if (image.mask[srcOffset + col])
+                    dest[col] = scratch[srcOffset + col];
+            }
+        }
+    }
+
+    return pixels;
+}
+const DC6Composite &DC6::getComposite(const uint32_t frameIdx, const int framesX, const int framesY) const {
+    const auto now = std::chrono::steady_clock::now();
+    for (auto &composite : _composites) {
+        if (composite.firstFrame == frameIdx && composite.framesX == framesX && composite.framesY == framesY) {
+            composite.lastUsed = now;
+            return composite;
+        }
+    }
+
+    if (_composites.size() >= DC6MaxComposites)
+        _composites.erase(std::ranges::min_element(_composites, {}, &DC6Composite::lastUsed));
+
+    DC6Composite composite{.firstFrame = frameIdx, .framesX = framesX, .framesY = framesY, .lastUsed = now};
+    const auto pixels = composeFrames(frameIdx, framesX, framesY, composite.bounds);
+
+    composite.texture.reset(Common::TextureTracker::createTexture(Singletons::getRendererProvider().getRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                                                                  SDL_TEXTUREACCESS_STATIC, composite.bounds.w, composite.bounds.h, "DC6", _path));
+    if (!composite.texture)
+        throw std::runtime_error(SDL_GetError());
+
+    SDL_UpdateTexture(composite.texture.get(), nullptr, pixels.data(), composite.bounds.w * static_cast<int>(sizeof(uint32_t)));
+    applyCompositeBlendMode(composite.texture.get());
+
+    return _composites.emplace_back(std::move(composite));
+}
+std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> DC6::createCompositeSurface(const uint32_t frameIdx, const int framesX, const int framesY,
+                                                                                    int &offsetX, int &offsetY) const {
+    SDL_Rect bounds;
+    const auto pixels = composeFrames(frameIdx, framesX, framesY, bounds);
+
+    std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> surface{SDL_CreateRGBSurfaceWithFormat(0, bounds.w, bounds.h, 32, SDL_PIXELFORMAT_RGBA8888),
+                                                                     SDL_FreeSurface};
+    if (!surface)
+        throw std::runtime_error(SDL_GetError());
+
+    for (auto row = 0; row < bounds.h; row++)
+        std::memcpy(static_cast<uint8_t *>(surface->pixels) + static_cast<size_t>(row) * surface->pitch, pixels.data() + static_cast<size_t>(row) * bounds.w,
+                    bounds.w * sizeof(uint32_t));
+
+    offsetX = bounds.x;
+    offsetY = bounds.y;
+    return surface;
 }
 void DC6::setBlendMode(const Enums::BlendMode blendMode) {
+    const auto trimChanged = (_blendMode == Enums::BlendMode::None) != (blendMode == Enums::BlendMode::None);
     this->_blendMode = blendMode;
 
-    switch (blendMode) {
+    // Switching to or from BlendMode::None changes whether frames are trimmed, so decoded directions are dropped and decoded again on use.
+    for (auto &cache : _directionCache) {
+        if (trimChanged) {
+            cache.texture.reset();
+            cache.frameRects.clear();
+            cache.frames.clear();
+            continue;
+        }
+
+        applyBlendMode(cache.texture.get());
+    }
+
+    // Composites built under BlendMode::None carry opaque frame backgrounds, so they are rebuilt rather than re-flagged.
+    if (trimChanged)
+        _composites.clear();
+
+    for (const auto &composite : _composites)
+        applyCompositeBlendMode(composite.texture.get());
+}
+void DC6::applyBlendMode(SDL_Texture *texture) const {
+    if (texture == nullptr)
+        return;
+
+    switch (_blendMode) {
     default:
     case Enums::BlendMode::None:
-        SDL_SetTextureBlendMode(_texture.get(), SDL_BLENDMODE_NONE);
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_NONE);
         break;
     case Enums::BlendMode::Blend:
-        SDL_SetTextureBlendMode(_texture.get(), SDL_BLENDMODE_BLEND);
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
         break;
     case Enums::BlendMode::Add:
-        SDL_SetTextureBlendMode(_texture.get(), SDL_BLENDMODE_ADD);
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_ADD);
         break;
     case Enums::BlendMode::Mod:
-        SDL_SetTextureBlendMode(_texture.get(), SDL_BLENDMODE_MOD);
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_MOD);
         break;
     }
 }
+void DC6::applyCompositeBlendMode(SDL_Texture *texture) const {
+    if (_blendMode == Enums::BlendMode::None)
+        SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+    else
+        applyBlendMode(texture);
+}
 void DC6::getFrameSize(const uint32_t frameIdx, int &frameWidth, int &frameHeight) const {
-    if (frameIdx >= _frameRects.size())
+    if (frameIdx >= _frames.size())
         throw std::runtime_error("Invalid frame index");
 
-    const auto &[x, y, w, h] = _frameRects[frameIdx];
+    const auto &frame = _frames[frameIdx];
 
-    frameWidth = w;
-    frameHeight = h;
+    frameWidth = static_cast<int>(frame.getWidth());
+    frameHeight = static_cast<int>(frame.getHeight());
 }
 void DC6::getFrameOffset(const uint32_t frameIdx, int &offsetX, int &offsetY) const {
     if (frameIdx >= _frames.size())
@@ -1,17 +1,47 @@
 #pragma once
 
 #include "Abyss/Common/Animation.h"
+#include "Abyss/Common/TextureTracker.h"
 #include "Abyss/Enums/BlendMode.h"
 #include "DC6Frame.h"
+#include "IndexedImage.h"
 #include "Palette.h"
 
 #include <SDL2/SDL.h>
 #include <array>
+#include <chrono>
+#include <memory>
+#include <optional>
 #include <vector>
 
 namespace Abyss::DataTypes {
 
+// Decoded frames and texture for a single direction. Directions are decoded on first use, so a sprite that only ever shows one direction never
+// pays for the others. The indexed frames are kept so a palette change only has to re-expand them into the existing texture.
+struct DC6Direction {
+    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture = {nullptr, Common::TextureTracker::destroy};
+    std::vector<SDL_Rect> frameRects{};
+    std::vector<IndexedImage> frames{};
+    std::chrono::steady_clock::time_point lastUsed{};
+};
+
+// A grid of frames flattened into a single texture, so static backgrounds are drawn with one copy. Bounds are relative to the draw position.
+struct DC6Composite {
+    uint32_t firstFrame{};
+    int framesX{};
+    int framesY{};
+    SDL_Rect bounds{};
+    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture = {nullptr, Common::TextureTracker::destroy};
+    std::chrono::steady_clock::time_point lastUsed{};
+};
+
+// Upper bound on the composites kept per sprite. Building one past the limit replaces the least recently drawn.
+constexpr size_t DC6MaxComposites = 8;
+
 class DC6 {
+    // The whole file is kept in memory; frames reference their RLE data in place.
+    std::vector<std::byte> _fileData{};
+    std::string _path;
     uint32_t _version;
     uint32_t _flags;
     uint32_t _encoding;
@@ -20,10 +50,20 @@ class DC6 {
     uint32_t _framesPerDirection;
     std::vector<uint32_t> _framePointers;
     std::vector<DC6Frame> _frames{};
-    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> _texture;
-    std::vector<SDL_Rect> _frameRects;
+    std::optional<Palette> _palette{};
+    mutable std::vector<DC6Direction> _directionCache{};
+    mutable std::vector<DC6Composite> _composites{};
     Enums::BlendMode _blendMode{};
 
+    static IndexedImage decodeFrame(const DC6Frame &frame);
+    void decodeDirection(uint32_t direction) const;
+    void uploadDirection(DC6Direction &direction) const;
+    const DC6Direction &getDirection(uint32_t frameIdx) const;
+    void applyBlendMode(SDL_Texture *texture) const;
+    void applyCompositeBlendMode(SDL_Texture *texture) const;
+    std::vector<uint32_t> composeFrames(uint32_t frameIdx, int framesX, int framesY, SDL_Rect &bounds) const;
+    const DC6Composite &getComposite(uint32_t frameIdx, int framesX, int framesY) const;
+
   public:
     explicit DC6(std::string_view path);
     DC6(std::string_view path, const Palette &palette);
@@ -41,6 +81,16 @@ class DC6 {
     void setBlendMode(Enums::BlendMode blendMode);
     void getFrameSize(uint32_t frameIdx, int &frameWidth, int &frameHeight) const;
     void getFrameOffset(uint32_t frameIdx, int &offsetX, int &offsetY) const;
+
+    // Decodes and uploads a direction ahead of its first draw.
+    void prefetch(uint32_t direction) const;
+    // Releases the textures of directions and composites that have not been drawn for at least maxIdle. Returns the number evicted.
+    size_t evictUnused(std::chrono::steady_clock::duration maxIdle);
+    [[nodiscard]] bool isDirectionDecoded(uint32_t direction) const;
+    // Renders a frame grid, laid out as draw(frameIdx, x, y, framesX, framesY) does, into a new surface. offsetX/offsetY receive the
+    // position of the surface relative to the draw position.
+    [[nodiscard]] std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> createCompositeSurface(uint32_t frameIdx, int framesX, int framesY,
+                                                                                                int &offsetX, int &offsetY) const;
 };
 
 typedef Common::Animation<DC6> DC6Animation;
@@ -4,7 +4,7 @@
 
 namespace Abyss::DataTypes {
 
-DC6Frame::DC6Frame(Streams::StreamReader &stream) {
+DC6Frame::DC6Frame(Streams::SpanReader &stream) {
   _flipped = stream.readUInt32();
   _width = stream.readUInt32();
   _height = stream.readUInt32();
@@ -14,10 +14,7 @@ DC6Frame::DC6Frame(Streams::StreamReader &stream) {
   _nextBlock = stream.readUInt32();
   _length = stream.readUInt32();
 
-    _frameData.resize(_length);
-    stream.readBytes(_frameData);
-
-    _terminator.resize(DC6TerminatorSize);
+    _frameData = stream.readSpan(_length);
     stream.readBytes(_terminator);
 }
 
@@ -37,8 +34,8 @@ uint32_t DC6Frame::getNextBlock() const { return _nextBlock; }
 
 uint32_t DC6Frame::getLength() const { return _length; }
 
-const std::vector<std::byte>& DC6Frame::getFrameData() const { return _frameData; }
+std::span<const std::byte> DC6Frame::getFrameData() const { return _frameData; }
 
-const std::vector<std::byte>& DC6Frame::getTerminator() const { return _terminator; }
+const std::array<std::byte, DC6TerminatorSize>& DC6Frame::getTerminator() const { return _terminator; }
 
 } // namespace Abyss::DataTypes
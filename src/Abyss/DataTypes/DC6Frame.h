@@ -1,9 +1,10 @@
 #pragma once
 
-#include "Abyss/Streams/StreamReader.h"
+#include "Abyss/Streams/SpanReader.h"
+#include <array>
 #include <cstddef>
 #include <cstdint>
-#include <vector>
+#include <span>
 
 namespace Abyss::DataTypes {
 
@@ -12,6 +13,8 @@ inline constexpr std::byte DC6MaxRunLength = static_cast<const std::byte>(0x7F);
 inline constexpr int DC6TerminationSize = 4;
 inline constexpr int DC6TerminatorSize = 3;
 
+// A frame header plus a view of its RLE data. The data is not copied: it points into the file buffer owned by the DC6, so a frame must not
+// outlive the sprite it was read from.
 class DC6Frame {
     uint32_t _flipped{};
     uint32_t _width{};
@@ -21,11 +24,11 @@ class DC6Frame {
     uint32_t _unknown{};
     uint32_t _nextBlock{};
     uint32_t _length{};
-    std::vector<std::byte> _frameData{};
-    std::vector<std::byte> _terminator{};
+    std::span<const std::byte> _frameData{};
+    std::array<std::byte, DC6TerminatorSize> _terminator{};
 
   public:
-    explicit DC6Frame(Streams::StreamReader& stream);
+    explicit DC6Frame(Streams::SpanReader& reader);
     [[nodiscard]] uint32_t getFlipped() const;
     [[nodiscard]] uint32_t getWidth() const;
     [[nodiscard]] uint32_t getHeight() const;
@@ -34,8 +37,8 @@ class DC6Frame {
     [[nodiscard]] uint32_t getUnknown() const;
     [[nodiscard]] uint32_t getNextBlock() const;
     [[nodiscard]] uint32_t getLength() const;
-    [[nodiscard]] const std::vector<std::byte>& getFrameData() const;
-    [[nodiscard]] const std::vector<std::byte>& getTerminator() const;
+    [[nodiscard]] std::span<const std::byte> getFrameData() const;
+    [[nodiscard]] const std::array<std::byte, DC6TerminatorSize>& getTerminator() const;
 };
 
 } // namespace Abyss::DataTypes
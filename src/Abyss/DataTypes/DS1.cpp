@@ -1,8 +1,12 @@
 #include "DS1.h"
 
 #include "Abyss/AbyssEngine.h"
-#include "Abyss/Streams/StreamReader.h"
+#include "Abyss/Streams/SpanReader.h"
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
 #include <stdexcept>
 
 namespace Abyss::DataTypes {
@@ -31,66 +35,86 @@ constexpr uint32_t hiddenBitmask = 0x80000000;
 constexpr uint32_t hiddenOffset = 31;
 constexpr uint32_t hiddenLength = 1;
 
-void Tile::decode(const uint8_t prop1, const uint8_t prop2, const uint8_t prop3, const uint8_t prop4) {
-    mainIndex = (prop3 >> 4) + ((prop4 & 0x03) << 4);
-    subIndex = prop2;
-    this->prop1 = prop1;
-    this->prop2 = prop2;
-    this->prop3 = prop3;
-    this->prop4 = prop4;
+namespace {
 
+uint32_t getProp1(const uint32_t cell) { return (cell & prop1Bitmask) >> prop1Offset; }
+
+uint32_t getMainIndex(const uint32_t cell) { return (cell & styleBitmask) >> styleOffset; }
+
+uint32_t getSubIndex(const uint32_t cell) { return (cell >> 8) & 0xFF; }
+
+// Orientation remap for DS1 versions before 7, extended to all 256 byte values so the lookup needs no range check.
+constexpr auto legacyOrientations = [] {
+    constexpr std::array<uint8_t, 25> dirLookup = {0x00, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x05, 0x05, 0x06, 0x06, 0x07, 0x07,
+                                                   0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x14};
+    std::array<uint8_t, 256> table{};
+    for (auto i = 0u; i < table.size(); i++)
+        table[i] = i < dirLookup.size() ? dirLookup[i] : static_cast<uint8_t>(i);
+    return table;
+}();
+
+// Reads a whole layer stream straight into its cell array. The stream is little-endian 32-bit words, which is the cell layout.
+void readCells(Streams::SpanReader &sr, std::vector<uint32_t> &cells) {
+    sr.readBytes(std::as_writable_bytes(std::span(cells)));
+    if constexpr (std::endian::native == std::endian::big) {
+        for (auto &cell : cells)
+            cell = (cell >> 24) | ((cell >> 8) & 0xFF00) | ((cell << 8) & 0xFF0000) | (cell << 24);
+    }
+}
+
+// Orientation streams only use prop1. The narrowing loop has no branches, so it vectorizes; older versions add a table remap.
+void readOrientations(Streams::SpanReader &sr, std::vector<uint32_t> &scratch, std::vector<uint8_t> &orientations, const bool legacy) {
+    scratch.resize(orientations.size());
+    readCells(sr, scratch);
+
+    const auto count = orientations.size();
+    const auto *source = scratch.data();
+    auto *dest = orientations.data();
+    for (size_t i = 0; i < count; i++)
+        dest[i] = static_cast<uint8_t>(source[i] & prop1Bitmask);
+
+    if (legacy) {
+        for (size_t i = 0; i < count; i++)
+            dest[i] = legacyOrientations[dest[i]];
+    }
 }
 
-void DS1::loadLayerStreams(Streams::StreamReader &sr) {
-    static const std::vector dirLookup = {0x00, 0x01, 0x02, 0x01, 0x02, 0x03, 0x03, 0x05, 0x05, 0x06,
-                                          0x06, 0x07, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
-                                          0x0F, 0x10, 0x11, 0x12, 0x14};
+} // namespace
+
+void DS1::loadLayerStreams(Streams::SpanReader &sr) {
+    std::vector<uint32_t> scratch;
 
+    // Each stream is read as one block and handed to the kernel for its layer kind; nothing branches per cell.
     for (const auto layerStreamTypes = getLayerStreamTypes(); const auto &layerStreamType : layerStreamTypes) {
-        for (auto y = 0; y < height; y++) {
-            for (auto x = 0; x < width; x++) {
-                const auto prop1 = sr.readUInt8();
-                const auto prop2 = sr.readUInt8();
-                const auto prop3 = sr.readUInt8();
-                const auto prop4 = sr.readUInt8();
-
-                switch (layerStreamType) {
-                case LayerStreamType::Wall1:
-                case LayerStreamType::Wall2:
-                case LayerStreamType::Wall3:
-                case LayerStreamType::Wall4: {
-                    const auto wallIndex = static_cast<int>(layerStreamType) - static_cast<int>(LayerStreamType::Wall1);
-                    layers.wall[wallIndex][x + y * width].decode(prop1, prop2, prop3, prop4);
-                }
-                break;
-                case LayerStreamType::Orientation1:
-                case LayerStreamType::Orientation2:
-                case LayerStreamType::Orientation3:
-                case LayerStreamType::Orientation4: {
-                    constexpr uint32_t wallTypeBitmask = 0x000000FF;
-                    const auto wallIndex = static_cast<int>(layerStreamType) - static_cast<int>(LayerStreamType::Orientation1);
-                    auto c = prop1;
-                    if (version < 7 && c < dirLookup.size())
-                        c = dirLookup[c];
-                    auto &tile = layers.wall[wallIndex][x + y * width];
-                    tile.type = static_cast<TileType>(c);
-                    // Zero field
-                }
-                break;
-                case LayerStreamType::Floor1:
-                case LayerStreamType::Floor2: {
-                    const auto floorIndex = static_cast<int>(layerStreamType) - static_cast<int>(LayerStreamType::Floor1);
-                    layers.floor[floorIndex][x + y * width].decode(prop1, prop2, prop3, prop4);
-                }
-                break;
-                case LayerStreamType::Shadow:
-                    layers.shadow[0][x + y * width].decode(prop1, prop2, prop3, prop4);
-                    break;
-                case LayerStreamType::Substitution:
-                    layers.substitution[0][x + y * width].decode(prop1, prop2, prop3, prop4);
-                    break;
-                }
-            }
+        switch (layerStreamType) {
+        case LayerStreamType::Wall1:
+        case LayerStreamType::Wall2:
+        case LayerStreamType::Wall3:
+        case LayerStreamType::Wall4: {
+            const auto wallIndex = static_cast<int>(layerStreamType) - static_cast<int>(LayerStreamType::Wall1);
+            readCells(sr, layers.wall[wallIndex].cells);
+        }
+        break;
+        case LayerStreamType::Orientation1:
+        case LayerStreamType::Orientation2:
+        case LayerStreamType::Orientation3:
+        case LayerStreamType::Orientation4: {
+            const auto wallIndex = static_cast<int>(layerStreamType) - static_cast<int>(LayerStreamType::Orientation1);
+            readOrientations(sr, scratch, layers.wall[wallIndex].orientations, version < 7);
+        }
+        break;
+        case LayerStreamType::Floor1:
+        case LayerStreamType::Floor2: {
+            const auto floorIndex = static_cast<int>(layerStreamType) - static_cast<int>(LayerStreamType::Floor1);
+            readCells(sr, layers.floor[floorIndex].cells);
+        }
+        break;
+        case LayerStreamType::Shadow:
+            readCells(sr, layers.shadow[0].cells);
+            break;
+        case LayerStreamType::Substitution:
+            readCells(sr, layers.substitution[0].cells);
+            break;
         }
     }
 }
@@ -128,15 +152,16 @@ std::vector<LayerStreamType> DS1::getLayerStreamTypes() const {
     return layerStreamTypes;
 }
 
-DS1::DS1(const std::string_view path) {
+DS1::DS1(const std::string_view path) : DS1(path, AbyssEngine::getInstance().loadBytes(path)) {}
+
+DS1::DS1(const std::string_view path, const std::span<const std::byte> data) {
     if (const auto lastSeparator = std::max(path.find_last_of('/'), path.find_last_of('\\')); lastSeparator != std::string_view::npos) {
         name = std::string(path.substr(lastSeparator + 1));
     } else {
         name = std::string(path);
     }
 
-    auto file = AbyssEngine::getInstance().loadFile(path);
-    Streams::StreamReader sr(file);
+    Streams::SpanReader sr(data);
 
     version = sr.readInt32();
     if (version < 3) {
@@ -181,64 +206,68 @@ DS1::DS1(const std::string_view path) {
 void DS1::resize(const int width, const int height) {
     const auto elements = width * height;
     for (auto &layer : layers.floor)
-        layer.resize(elements);
-    for (auto &layer : layers.wall)
-        layer.resize(elements);
+        layer.cells.resize(elements);
+    for (auto &layer : layers.wall) {
+        layer.cells.resize(elements);
+        layer.orientations.resize(elements);
+    }
     for (auto &layer : layers.shadow)
-        layer.resize(elements);
+        layer.cells.resize(elements);
     for (auto &layer : layers.substitution)
-        layer.resize(elements);
+        layer.cells.resize(elements);
 }
 
-void DS1::bindTileReferences(const std::vector<DT1> &dt1s) {
+void DS1::bindTileReferences(const DT1TileIndex &tileIndex, const bool weightedVariants) {
+    tileTable.assign(1, ResolvedTile{});
+    absl::flat_hash_map<ResolvedTile, TileId> tileIds;
+
     for (auto &layer : layers.floor)
-        bindLayerTileReferences(layer, dt1s);
+        bindLayerTileReferences(layer, tileIndex, weightedVariants, tileIds);
 
     for (auto &layer : layers.shadow)
-        bindLayerTileReferences(layer, dt1s);
+        bindLayerTileReferences(layer, tileIndex, weightedVariants, tileIds);
 
     for (auto &layer : layers.wall)
-        bindLayerTileReferences(layer, dt1s);
+        bindLayerTileReferences(layer, tileIndex, weightedVariants, tileIds);
 
     for (auto &layer : layers.substitution)
-        bindLayerTileReferences(layer, dt1s);
+        bindLayerTileReferences(layer, tileIndex, weightedVariants, tileIds);
 }
 
+void DS1::bindLayerTileReferences(DS1Layer &layer, const DT1TileIndex &tileIndex, const bool weightedVariants,
+                                  absl::flat_hash_map<ResolvedTile, TileId> &tileIds) {
+    layer.tiles.assign(layer.cells.size(), 0);
+
+    for (size_t cell = 0; cell < layer.cells.size(); cell++) {
+        const auto value = layer.cells[cell];
+        if (getProp1(value) == 0)
+            continue;
+
+        ResolvedTile tile;
+        tile.type = layer.orientations.empty() ? TileType::Floor : static_cast<TileType>(layer.orientations[cell]);
+        const auto mainIndex = getMainIndex(value);
+        const auto subIndex = getSubIndex(value);
 
-void DS1::bindLayerTileReferences(std::vector<Tile> &tiles, const std::vector<DT1> &dt1s) {
-    for (auto &tile : tiles) {
-        if (tile.prop1 == 0)
+        const auto *candidate = weightedVariants ? tileIndex.selectWeighted(tile.type, mainIndex, subIndex, static_cast<uint32_t>(cell))
+                                                 : tileIndex.first(tile.type, mainIndex, subIndex);
+        if (candidate == nullptr)
             continue;
-        auto foundTile = false;
-        for (const auto &dt1 : dt1s) {
-            if (foundTile)
-                break;
-            for (const auto &tileInfo : dt1.tiles) {
-                if (tileInfo.header.orientation != tile.type)
-                    continue;
-                if (tileInfo.header.mainIndex != tile.mainIndex)
-                    continue;
-                if (tileInfo.header.subIndex != tile.subIndex)
-                    continue;
-                tile.dt1Ref = &dt1;
-                tile.dt1Index = tileInfo.dt1Index;
-                if (tile.type == TileType::RightPartOfNorthCornerWall) {
-                    // Get tile with style of LeftPartOfNorthCornerWall
-                    for (const auto &tileInfo2 : dt1.tiles) {
-                        if (tileInfo2.header.orientation != TileType::LeftPartOfNorthCornerWall)
-                            continue;
-                        if (tileInfo2.header.mainIndex != tile.mainIndex)
-                            continue;
-                        if (tileInfo2.header.subIndex != tile.subIndex)
-                            continue;
-                        tile.dt1IndexAlt = tileInfo2.dt1Index;
-                        break;
-                    }
-                }
-                foundTile = true;
-                break;
+
+        tile.dt1Ref = candidate->dt1;
+        tile.dt1Index = candidate->dt1Index;
+        if (tile.type == TileType::RightPartOfNorthCornerWall) {
+            // Get tile with style of LeftPartOfNorthCornerWall from the same DT1
+            if (const auto *variants = tileIndex.find(TileType::LeftPartOfNorthCornerWall, mainIndex, subIndex)) {
+                const auto it = std::ranges::find(variants->candidates, candidate->dt1, &DT1TileCandidate::dt1);
+                if (it != variants->candidates.end())
+                    tile.dt1IndexAlt = it->dt1Index;
             }
         }
+
+        const auto [it, inserted] = tileIds.try_emplace(tile, static_cast<TileId>(tileTable.size()));
+        if (inserted)
+            tileTable.push_back(tile);
+        layer.tiles[cell] = it->second;
     }
 }
 
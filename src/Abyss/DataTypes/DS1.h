@@ -1,9 +1,12 @@
 #pragma once
 
 #include "DT1.h"
-#include "Abyss/Streams/StreamReader.h"
+#include "DT1TileIndex.h"
+#include "Abyss/Streams/SpanReader.h"
 
+#include <absl/container/flat_hash_map.h>
 #include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -40,33 +43,49 @@ struct TileSubstitution {
     uint32_t sub;
 };
 
-class Tile {
-public:
-    void decode(uint8_t prop1, uint8_t prop2, uint8_t prop3, uint8_t prop4);
-    uint8_t prop1{};
-    uint8_t prop2{};
-    uint8_t prop3{};
-    uint8_t prop4{};
-    TileType type{};
-    uint16_t mainIndex{};
-    uint16_t subIndex{};
+// A map cell bound to a DT1 tile. Layers do not store these per cell; they store a TileId into a table of the distinct resolved tiles.
+struct ResolvedTile {
     const DT1 *dt1Ref{nullptr};
     uint32_t dt1Index{};
     uint32_t dt1IndexAlt{}; // Super secret alt index explicitly for RightPartOfNorthCornerWall
+    TileType type{};
+
+    bool operator==(const ResolvedTile &) const = default;
+
+    template <typename H> friend H AbslHashValue(H hash, const ResolvedTile &tile) {
+        return H::combine(std::move(hash), tile.dt1Ref, tile.dt1Index, tile.dt1IndexAlt, tile.type);
+    }
 };
 
-using TileMap = std::vector<Tile>;
+// Index into a resolved tile table. Id 0 is always the empty tile.
+using TileId = uint32_t;
+using TileLayer = std::vector<TileId>;
+
+struct DS1Layer {
+    // Raw cell words as stored in the layer stream: prop1 in the low byte, then prop2, prop3 and prop4.
+    std::vector<uint32_t> cells{};
+    // Orientation stream of a wall layer, one TileType per cell. Empty for the other layer kinds, whose tiles are looked up as floors.
+    std::vector<uint8_t> orientations{};
+    // Filled by DS1::bindTileReferences.
+    TileLayer tiles{};
+};
 
 class DS1 {
-    void loadLayerStreams(Streams::StreamReader &sr);
-    static void bindLayerTileReferences(std::vector<Tile> &tiles, const std::vector<DT1> &dt1s);
+    void loadLayerStreams(Streams::SpanReader &sr);
+    void bindLayerTileReferences(DS1Layer &layer, const DT1TileIndex &tileIndex, bool weightedVariants,
+                                 absl::flat_hash_map<ResolvedTile, TileId> &tileIds);
     [[nodiscard]] std::vector<LayerStreamType> getLayerStreamTypes() const;
 
 public:
+    // Loads through FileLoader::loadBytes, which serializes archive reads, so DS1s can be loaded on worker threads.
     explicit DS1(std::string_view path);
+    // Parses a DS1 whose bytes are already loaded. `path` only names it.
+    DS1(std::string_view path, std::span<const std::byte> data);
     void resize(int width, int height);
 
-    void bindTileReferences(const std::vector<DT1> &dt1s);
+    // Resolves every cell to a tile. Cells take the first matching tile unless weightedVariants is set, in which case each cell picks a
+    // variant by rarity, seeded by its position.
+    void bindTileReferences(const DT1TileIndex &tileIndex, bool weightedVariants = false);
 
     std::string name{};
     int32_t version{};
@@ -77,11 +96,14 @@ public:
     std::vector<std::string> files{};
 
     struct {
-        std::vector<TileMap> floor{};
-        std::vector<TileMap> wall{};
-        std::vector<TileMap> shadow{};
-        std::vector<TileMap> substitution{};
+        std::vector<DS1Layer> floor{};
+        std::vector<DS1Layer> wall{};
+        std::vector<DS1Layer> shadow{};
+        std::vector<DS1Layer> substitution{};
     } layers;
+
+    // Distinct tiles the layers resolve to, indexed by TileId.
+    std::vector<ResolvedTile> tileTable{ResolvedTile{}};
 };
 
 } // namespace Abyss::DataTypes
@@ -1,26 +1,153 @@
 #include "DT1.h"
 
+#include <absl/strings/str_cat.h>
 #include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
 #include <cmath>
+#include <exception>
+#include <future>
 #include <limits>
 #include <stdexcept>
 #include <string_view>
 #include <vector>
 
 #include "Abyss/AbyssEngine.h"
-#include "Abyss/Streams/StreamReader.h"
+#include "Abyss/Common/PixelKernels.h"
 
 namespace Abyss::DataTypes {
 
-DT1::DT1(const std::string_view path, const Palette &palette) {
+namespace {
+
+DT1TileHeader readTileHeader(Streams::SpanReader &sr) {
+    DT1TileHeader tileHeader;
+    tileHeader.direction = sr.readUInt32();
+    tileHeader.roofHeight = sr.readUInt16();
+    tileHeader.soundIndex = sr.readUInt8();
+    tileHeader.animated = sr.readUInt8();
+    tileHeader.height = sr.readInt32();
+    tileHeader.width = sr.readInt32();
+    sr.skip(4);
+    tileHeader.orientation = static_cast<TileType>(sr.readUInt32());
+    tileHeader.mainIndex = sr.readUInt32();
+    tileHeader.subIndex = sr.readUInt32();
+    tileHeader.rarityOrFrameIndex = sr.readUInt32();
+    sr.skip(4);
+    for (DT1SubtileFlag &flag : tileHeader.subtileFlags) {
+        flag = static_cast<DT1SubtileFlag>(sr.readUInt8());
+    }
+    sr.skip(7);
+    tileHeader.blockHeaderPointer = sr.readUInt32();
+    tileHeader.blockDataLength = sr.readUInt32();
+    tileHeader.numberOfBlocks = sr.readUInt32();
+    sr.skip(12);
+    return tileHeader;
+}
+
+// One run per row of the 32x15 isometric diamond a floor block encodes: where it starts in the row, how many pixels it has and where they
+// start in the 256 byte block.
+struct FloorBlockRow {
+    int x;
+    int count;
+    int sourceOffset;
+};
+
+constexpr auto FloorBlockRows = [] {
+    constexpr int xJmp[15] = {14, 12, 10, 8, 6, 4, 2, 0, 2, 4, 6, 8, 10, 12, 14};
+    constexpr int nmbPixels[15] = {4, 8, 12, 16, 20, 24, 28, 32, 28, 24, 20, 16, 12, 8, 4};
+
+    std::array<FloorBlockRow, 15> rows{};
+    int sourceOffset = 0;
+    for (auto y = 0; y < 15; y++) {
+        rows[y] = {.x = xJmp[y], .count = nmbPixels[y], .sourceOffset = sourceOffset};
+        sourceOffset += nmbPixels[y];
+    }
+    return rows;
+}();
+
+constexpr int FloorBlockWidth = 32;
+constexpr int FloorBlockSize = 256;
+
+// Block decoders write straight into the tile image and check the block against the image once up front, or once per run for RLE, instead of
+// per pixel. They return false for malformed data rather than throwing from the inner loop.
+bool decodeFloorBlock(const std::span<const std::byte> data, IndexedImage &image, const int originX, const int originY) {
+    if (data.size() != FloorBlockSize || originX < 0 || originY < 0 || originX + FloorBlockWidth > image.width ||
+        originY + static_cast<int>(FloorBlockRows.size()) > image.height)
+        return false;
+
+    auto *dest = image.indices.data() + static_cast<size_t>(originY) * image.width + originX;
+    for (const auto &row : FloorBlockRows) {
+        std::memcpy(dest + row.x, data.data() + row.sourceOffset, row.count);
+        dest += image.width;
+    }
+    return true;
+}
+
+// 1st byte is pixels to "jump", 2nd is number of "solid" pixels, followed by the pixel color indexes. when 1st and 2nd bytes are 0 and 0,
+// next line.
+bool decodeRleBlock(const std::span<const std::byte> data, IndexedImage &image, const int originX, const int originY) {
+    const auto *source = reinterpret_cast<const uint8_t *>(data.data());
+    const auto *end = source + data.size();
+    int x = originX;
+    int y = originY;
+
+    while (end - source >= 2) {
+        const auto toSkip = source[0];
+        const auto toDraw = source[1];
+        source += 2;
+
+        if (toSkip == 0 && toDraw == 0) {
+            x = originX;
+            y++;
+            continue;
+        }
+
+        x += toSkip;
+        if (end - source < toDraw || x < 0 || y < 0 || y >= image.height || x + toDraw > image.width)
+            return false;
+
+        Common::PixelKernels::copyRun(source, image.indices.data() + static_cast<size_t>(y) * image.width + x, nullptr, toDraw);
+        source += toDraw;
+        x += toDraw;
+    }
+
+    return source == end;
+}
+
+// Decode cache payload: a uint32 tile count, one CachedTileRecord per tile, then the trimmed palette indices of every stored tile, each
+// aligned to 16 bytes. Bump the version whenever decoded output changes.
+constexpr uint32_t CacheDecoderVersion = 1;
+constexpr std::string_view CacheKind = "dt1c";
+
+struct CachedTileRecord {
+    int32_t width;
+    int32_t height;
+    int32_t offsetX;
+    int32_t offsetY;
+    uint32_t dataOffset;
+    uint32_t stored;
+};
+
+size_t cacheRecordOffset(const size_t tileIndex) { return sizeof(uint32_t) + tileIndex * sizeof(CachedTileRecord); }
+
+size_t alignCacheOffset(const size_t offset) {
+    constexpr auto alignment = Common::DecodeCache::PayloadAlignment;
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+} // namespace
+
+DT1::DT1(const std::string_view path, const Palette &palette)
+    : _path(path), _fileData(AbyssEngine::getInstance().loadBytes(path)), _palette(palette), _tileSet(std::make_shared<DT1TileSet>()) {
     if (const auto lastSeparator = std::max(path.find_last_of('/'), path.find_last_of('\\')); lastSeparator != std::string_view::npos) {
         name = std::string(path.substr(lastSeparator + 1));
     } else {
         name = std::string(path);
     }
 
-    auto file = AbyssEngine::getInstance().loadFile(path);
-    Streams::StreamReader sr(file);
+    _sourceHash = Common::DecodeCache::hashBytes(_fileData);
+    Streams::SpanReader sr(_fileData);
 
     int versionMajor = sr.readUInt32();
     int versionMinor = sr.readUInt32();
@@ -33,164 +160,412 @@ DT1::DT1(const std::string_view path, const Palette &palette) {
     uint32_t pointerToTileHeaders = sr.readUInt32();
     sr.seek(pointerToTileHeaders);
 
-    std::vector<DT1TileHeader> tileHeaders(numberOfTiles);
-
-    for (auto &tileHeader : tileHeaders) {
-        tileHeader.direction = sr.readUInt32();
-        tileHeader.roofHeight = sr.readUInt16();
-        tileHeader.soundIndex = sr.readUInt8();
-        tileHeader.animated = sr.readUInt8();
-        tileHeader.height = sr.readInt32();
-        tileHeader.width = sr.readInt32();
-        sr.skip(4);
-        tileHeader.orientation = static_cast<TileType>(sr.readUInt32());
-        tileHeader.mainIndex = sr.readUInt32();
-        tileHeader.subIndex = sr.readUInt32();
-        tileHeader.rarityOrFrameIndex = sr.readUInt32();
-        sr.skip(4);
-        for (DT1SubtileFlag &flag : tileHeader.subtileFlags) {
-            flag = static_cast<DT1SubtileFlag>(sr.readByte());
+    _tileSet->tiles.resize(numberOfTiles);
+    for (auto &tile : _tileSet->tiles)
+        tile.header = readTileHeader(sr);
+
+    for (auto i = 0u; i < numberOfTiles; i++) {
+        _tileSet->tiles[i].dt1Index = static_cast<int>(i);
+        readTileLayout(sr, _tileSet->tiles[i]);
+    }
+
+    if (auto cache = AbyssEngine::getInstance().getDecodeCache().load(_path, CacheKind, CacheDecoderVersion, _fileData.size(), _sourceHash)) {
+        uint32_t cachedTiles = 0;
+        if (cache->size() >= cacheRecordOffset(numberOfTiles))
+            std::memcpy(&cachedTiles, cache->data(), sizeof(cachedTiles));
+        if (cachedTiles == numberOfTiles)
+            _cache = std::move(*cache);
+    }
+}
+
+void DT1::readTileLayout(Streams::SpanReader &sr, DT1Tile &tile) {
+    const auto &tileHeader = tile.header;
+
+    tile.blocks.resize(tileHeader.numberOfBlocks);
+    sr.seek(tileHeader.blockHeaderPointer);
+    for (auto &blockHeader : tile.blocks) {
+        blockHeader.posX = sr.readInt16();
+        blockHeader.posY = sr.readInt16();
+        sr.skip(2);
+        blockHeader.gridX = sr.readUInt8();
+        blockHeader.gridY = sr.readUInt8();
+        blockHeader.format = sr.readUInt16();
+        blockHeader.dataLength = sr.readInt32();
+        sr.skip(2);
+        blockHeader.encodedDataFileOffset = sr.readUInt32();
+    }
+
+    tile.width = 160; // Not technically true, but works for us
+    tile.height = 0;
+
+    if (tileHeader.orientation == TileType::Floor || tileHeader.orientation == TileType::Roof) {
+        tile.height = 80;
+    } else {
+        int minCellY = std::numeric_limits<int>::max();
+        int maxCellY = std::numeric_limits<int>::min();
+
+        for (const auto &blockHeader : tile.blocks) {
+            minCellY = std::min(minCellY, static_cast<int>(blockHeader.posY));
+            maxCellY = std::max(maxCellY, blockHeader.posY + 32);
+        }
+
+        tile.height = maxCellY - minCellY;
+
+        if (minCellY < 0)
+            tile.drawOffsetY = -minCellY;
+    }
+}
+
+void DT1::decodeTile(DT1Tile &currentTile) const {
+    if (!loadCachedTile(currentTile))
+        decodeBlocks(currentTile);
+
+    currentTile.pixels.resize(currentTile.image.indices.size());
+    currentTile.image.expand(_palette, currentTile.pixels.data(), currentTile.image.width * static_cast<int>(sizeof(uint32_t)));
+    currentTile.decoded = true;
+}
+
+void DT1::decodeBlocks(DT1Tile &currentTile) const {
+    Streams::SpanReader sr(_fileData);
+    const auto &tileHeader = currentTile.header;
+
+    currentTile.image = IndexedImage(currentTile.width, currentTile.height, false);
+    auto &image = currentTile.image;
+
+    for (const auto &blockHeader : currentTile.blocks) {
+        sr.seek(blockHeader.encodedDataFileOffset + tileHeader.blockHeaderPointer);
+        const auto encodedData = sr.readSpan(blockHeader.dataLength);
+
+        const auto originX = static_cast<int>(blockHeader.posX);
+        const auto originY = blockHeader.posY + currentTile.drawOffsetY;
+        const auto decoded = blockHeader.format == 1 ? decodeFloorBlock(encodedData, image, originX, originY)
+                                                     : decodeRleBlock(encodedData, image, originX, originY);
+        if (!decoded)
+            throw std::runtime_error(absl::StrCat("Invalid block in DT1 tile ", currentTile.dt1Index, " of ", name));
+    }
+
+    // Only the opaque bounds are kept; drawTile() adds the offset back. Wall tiles in particular are mostly transparent.
+    currentTile.image.trim();
+}
+
+bool DT1::isTileCached(const uint32_t tileIndex) const {
+    if (_cache.empty())
+        return false;
+
+    CachedTileRecord record;
+    std::memcpy(&record, _cache.data() + cacheRecordOffset(tileIndex), sizeof(record));
+    return record.stored != 0;
+}
+
+bool DT1::loadCachedTile(DT1Tile &tile) const {
+    if (!isTileCached(tile.dt1Index))
+        return false;
+
+    CachedTileRecord record;
+    std::memcpy(&record, _cache.data() + cacheRecordOffset(tile.dt1Index), sizeof(record));
+    const auto size = static_cast<size_t>(record.width) * record.height;
+    if (record.width < 0 || record.height < 0 || record.dataOffset + size > _cache.size())
+        return false;
+
+    auto &image = tile.image;
+    image = IndexedImage(record.width, record.height, false);
+    image.offsetX = record.offsetX;
+    image.offsetY = record.offsetY;
+    std::memcpy(image.indices.data(), _cache.data() + record.dataOffset, size);
+    return true;
+}
+
+void DT1::storeCache() const {
+    const auto &decodeCache = AbyssEngine::getInstance().getDecodeCache();
+    if (!decodeCache.isEnabled())
+        return;
+
+    // Tiles cached by earlier runs but not decoded in this one are carried over, so the entry only ever grows.
+    std::vector<CachedTileRecord> records(_tileSet->tiles.size());
+    std::vector<IndexedImage> carried(_tileSet->tiles.size());
+    auto dataSize = alignCacheOffset(cacheRecordOffset(_tileSet->tiles.size()));
+    for (size_t i = 0; i < _tileSet->tiles.size(); i++) {
+        const auto *image = &_tileSet->tiles[i].image;
+        if (!_tileSet->tiles[i].decoded) {
+            if (!isTileCached(i))
+                continue;
+
+            auto tile = DT1Tile{};
+            tile.dt1Index = static_cast<int>(i);
+            if (!loadCachedTile(tile))
+                continue;
+            carried[i] = std::move(tile.image);
+            image = &carried[i];
         }
-        sr.skip(7);
-        tileHeader.blockHeaderPointer = sr.readUInt32();
-        tileHeader.blockDataLength = sr.readUInt32();
-        tileHeader.numberOfBlocks = sr.readUInt32();
-        sr.skip(12);
-    }
-
-    for (auto &tileHeader : tileHeaders) {
-        auto &currentTile = tiles.emplace_back();
-        currentTile.header = tileHeader;
-
-        std::vector<DT1BlockHeader> blockHeaders(tileHeader.numberOfBlocks);
-        sr.seek(tileHeader.blockHeaderPointer);
-        for (auto &blockHeader : blockHeaders) {
-            blockHeader.posX = sr.readInt16();
-            blockHeader.posY = sr.readInt16();
-            sr.skip(2);
-            blockHeader.gridX = sr.readUInt8();
-            blockHeader.gridY = sr.readUInt8();
-            blockHeader.format = sr.readUInt16();
-            blockHeader.dataLength = sr.readInt32();
-            sr.skip(2);
-            blockHeader.encodedDataFileOffset = sr.readUInt32();
+
+        records[i] = {.width = image->width, .height = image->height, .offsetX = image->offsetX, .offsetY = image->offsetY,
+                      .dataOffset = static_cast<uint32_t>(dataSize), .stored = 1};
+        dataSize = alignCacheOffset(dataSize + image->indices.size());
+    }
+
+    std::vector<std::byte> payload(dataSize);
+    const auto tileCount = static_cast<uint32_t>(_tileSet->tiles.size());
+    std::memcpy(payload.data(), &tileCount, sizeof(tileCount));
+    std::memcpy(payload.data() + cacheRecordOffset(0), records.data(), records.size() * sizeof(CachedTileRecord));
+    for (size_t i = 0; i < _tileSet->tiles.size(); i++) {
+        if (records[i].stored == 0)
+            continue;
+        const auto &image = _tileSet->tiles[i].decoded ? _tileSet->tiles[i].image : carried[i];
+        std::memcpy(payload.data() + records[i].dataOffset, image.indices.data(), image.indices.size());
+    }
+
+    decodeCache.store(_path, CacheKind, CacheDecoderVersion, _fileData.size(), _sourceHash, payload);
+}
+
+void DT1::prefetch(const std::span<const uint32_t> tileIndices) {
+    std::vector<uint32_t> pending;
+    for (const auto index : tileIndices) {
+        if (index < _tileSet->tiles.size() && !_tileSet->tiles[index].decoded)
+            pending.push_back(index);
+    }
+    std::ranges::sort(pending);
+    pending.erase(std::ranges::unique(pending).begin(), pending.end());
+    if (pending.empty())
+        return;
+    const auto cacheMiss = std::ranges::any_of(pending, [this](const uint32_t index) { return !isTileCached(index); });
+
+    // Tiles are independent of each other, so they are decoded in parallel chunks on the loader pool. Chunks are smaller than an even split
+    // so that several DT1s loading at once interleave well.
+    auto &threadPool = AbyssEngine::getInstance().getThreadPool();
+    const auto chunkSize = std::max<size_t>(16, pending.size() / (threadPool.getThreadCount() * 4));
+    std::vector<std::future<void>> futures;
+
+    for (size_t first = 0; first < pending.size(); first += chunkSize) {
+        const auto last = std::min(first + chunkSize, pending.size());
+        futures.emplace_back(threadPool.submit([this, &pending, first, last] {
+            for (auto i = first; i < last; i++)
+                decodeTile(_tileSet->tiles[pending[i]]);
+        }));
+    }
+
+    // Every chunk must finish before rethrowing, as they reference the pending list on this stack.
+    std::exception_ptr error;
+    for (auto &future : futures) {
+        try {
+            threadPool.wait(future);
+        } catch (...) {
+            error = std::current_exception();
         }
+    }
+    if (error)
+        std::rethrow_exception(error);
 
-        currentTile.dt1Index = static_cast<int>(tiles.size()) - 1;
-        currentTile.width = 160; // Not technically true, but works for us
-        currentTile.height = 0;
+    packAtlas(pending);
+    if (cacheMiss)
+        storeCache();
+}
 
-        if (tileHeader.orientation == TileType::Floor || tileHeader.orientation == TileType::Roof) {
-            currentTile.height = 80;
-        } else {
-            int minCellY = std::numeric_limits<int>::max();
-            int maxCellY = std::numeric_limits<int>::min();
+void DT1::prefetchAll() {
+    std::vector<uint32_t> all(_tileSet->tiles.size());
+    for (auto i = 0u; i < all.size(); i++)
+        all[i] = i;
+    prefetch(all);
+}
 
-            for (const auto &blockHeader : blockHeaders) {
-                minCellY = std::min(minCellY, static_cast<int>(blockHeader.posY));
-                maxCellY = std::max(maxCellY, blockHeader.posY + 32);
-            }
+void DT1::decodeOnDemand(DT1Tile &tile) const {
+    decodeTile(tile);
 
-            currentTile.height = maxCellY - minCellY;
+    packOnDemand(tile);
+    if (tile.page >= 0)
+        uploadTile(tile, _tileSet->pages[tile.page], name);
+}
+
+void DT1::packAtlas(const std::span<const uint32_t> tileIndices) const {
+    // Shelf packing, tallest tiles first. Floors all share one height, so they fill whole shelves. Each call starts new pages, as earlier
+    // pages may already be uploaded; tiles decoded on demand go to their own page instead (see packOnDemand).
+    std::vector<uint32_t> order;
+    for (const auto index : tileIndices) {
+        if (!_tileSet->tiles[index].image.empty())
+            order.push_back(index);
+    }
+    std::ranges::stable_sort(order, std::greater{}, [this](const uint32_t index) { return _tileSet->tiles[index].image.height; });
+
+    auto &pages = _tileSet->pages;
+    const auto firstPage = pages.size();
+    int shelfX = 0;
+    int shelfY = 0;
+    int shelfHeight = 0;
 
-            if (minCellY < 0)
-                currentTile.drawOffsetY = -minCellY;
+    for (const auto index : order) {
+        auto &tile = _tileSet->tiles[index];
+        const auto width = tile.image.width;
+        const auto height = tile.image.height;
+        if (width > AtlasPageSize || height > AtlasPageSize)
+            throw std::runtime_error(absl::StrCat("DT1 tile ", index, " in ", name, " does not fit in an atlas page"));
+
+        if (shelfX + width > AtlasPageSize) {
+            shelfX = 0;
+            shelfY += shelfHeight + AtlasPadding;
+            shelfHeight = 0;
+        }
+
+        if (pages.size() == firstPage || shelfY + height > AtlasPageSize) {
+            pages.emplace_back();
+            shelfX = 0;
+            shelfY = 0;
+            shelfHeight = 0;
         }
 
-        currentTile.texture.reset(SDL_CreateTexture(AbyssEngine::getInstance().getRenderer(), SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STATIC,
-                                                    currentTile.width, currentTile.height));
-        SDL_SetTextureBlendMode(currentTile.texture.get(), SDL_BLENDMODE_BLEND);
-
-        // grab a pointer to the texture data
-        std::vector<uint32_t> pixels(currentTile.width * currentTile.height);
-        const int pitch = currentTile.width * sizeof(uint32_t);
-
-        for (const auto &blockHeader : blockHeaders) {
-            std::vector<uint8_t> encodedData(blockHeader.dataLength);
-            sr.seek(blockHeader.encodedDataFileOffset + tileHeader.blockHeaderPointer);
-            sr.readBytes(encodedData);
-
-            if (blockHeader.format == 1) {
-                // isometric floor
-                constexpr int xJmp[15] = {14, 12, 10, 8, 6, 4, 2, 0, 2, 4, 6, 8, 10, 12, 14};
-                constexpr int nmbPixels[15] = {4, 8, 12, 16, 20, 24, 28, 32, 28, 24, 20, 16, 12, 8, 4};
-
-                if (encodedData.size() != 256)
-                    throw std::runtime_error("Invalid encoded data size");
-
-                int x;
-                int y = 0;
-                int n;
-                int length = static_cast<int>(encodedData.size());
-                int dataOffset = 0;
-                while (length > 0) {
-                    x = xJmp[y];
-                    n = nmbPixels[y];
-                    length -= n;
-                    while (n--) {
-                        const auto targetX = x + blockHeader.posX;
-                        const auto targetY = y + currentTile.drawOffsetY + blockHeader.posY;
-                        const auto index = encodedData.at(dataOffset++);
-                        if (index == 0) {
-                            pixels[targetY * currentTile.width + targetX] = 0;
-                            x++;
-                            continue;
-                        }
-                        const auto &paletteEntry = palette.getEntry(index);
-                        const auto color = (paletteEntry.getBlue() << 24) | (paletteEntry.getGreen() << 16) | (paletteEntry.getRed() << 8) | 0xFF;
-                        pixels[targetY * currentTile.width + targetX] = color;
-                        x++;
-                    }
-                    y++;
-                }
-            } else {
-                // RLE decoding
-                // 1st byte is pixels to "jump", 2nd is number of "solid" pixels, followed by the pixel color indexes. when 1st and 2nd bytes are 0 and 0, next
-                // line.
-                int x = 0;
-                int y = 0;
-                int length = static_cast<int>(encodedData.size());
-                int dataOffset = 0;
-                while (length > 0) {
-                    const auto toSkip = encodedData.at(dataOffset++);
-                    auto toDraw = encodedData.at(dataOffset++);
-                    length -= 2;
-                    if (toSkip == 0 && toDraw == 0) {
-                        x = 0;
-                        y++;
-                        continue;
-                    }
-                    x += toSkip;
-                    length -= toDraw;
-                    while (toDraw--) {
-                        const auto targetX = x + blockHeader.posX;
-                        const auto targetY = y + currentTile.drawOffsetY + blockHeader.posY;
-                        const auto index = encodedData.at(dataOffset++);
-                        if (index == 0) {
-                            pixels[targetY * currentTile.width + targetX] = 0;
-                            x++;
-                            continue;
-                        }
-                        const auto &paletteEntry = palette.getEntry(index);
-                        const auto color = (paletteEntry.getBlue() << 24) | (paletteEntry.getGreen() << 16) | (paletteEntry.getRed() << 8) | 0xFF;
-                        pixels[targetY * currentTile.width + targetX] = color;
-                        x++;
-                    }
-                }
+        auto &page = pages.back();
+        tile.page = static_cast<int>(pages.size()) - 1;
+        tile.atlasRect = {shelfX, shelfY, width, height};
+        page.width = std::max(page.width, shelfX + width);
+        page.height = std::max(page.height, shelfY + height);
+
+        shelfX += width + AtlasPadding;
+        shelfHeight = std::max(shelfHeight, height);
+    }
+}
+
+void DT1::packOnDemand(DT1Tile &tile) const {
+    if (tile.image.empty())
+        return;
+
+    const auto width = tile.image.width;
+    const auto height = tile.image.height;
+    if (width > AtlasPageSize || height > AtlasPageSize)
+        throw std::runtime_error(absl::StrCat("DT1 tile ", tile.dt1Index, " in ", name, " does not fit in an atlas page"));
+
+    auto &pages = _tileSet->pages;
+    auto &shelf = _tileSet->onDemandShelf;
+    if (shelf.page >= 0 && shelf.x + width > pages[shelf.page].width) {
+        shelf.x = 0;
+        shelf.y += shelf.height + AtlasPadding;
+        shelf.height = 0;
+    }
+
+    // The page texture is created with its final size, so tiles decoded later only upload their own rectangle.
+    if (shelf.page < 0 || shelf.x + width > pages[shelf.page].width || shelf.y + height > pages[shelf.page].height) {
+        const auto size = getOnDemandPageSize(width, height);
+        auto &page = pages.emplace_back();
+        page.width = size;
+        page.height = size;
+        shelf.page = static_cast<int>(pages.size()) - 1;
+        shelf.x = 0;
+        shelf.y = 0;
+        shelf.height = 0;
+    }
+
+    tile.page = shelf.page;
+    tile.atlasRect = {shelf.x, shelf.y, width, height};
+    shelf.x += width + AtlasPadding;
+    shelf.height = std::max(shelf.height, height);
+}
+
+int DT1::getOnDemandPageSize(const int width, const int height) const {
+    // Room for every tile that may still be decoded on demand, at its layout size before trimming. Usually only a few tiles were not
+    // prefetched, so the page stays small; if more turn up than it holds, another page is sized the same way.
+    int64_t area = 0;
+    for (const auto &tile : _tileSet->tiles) {
+        if (tile.page < 0 && !(tile.decoded && tile.image.empty()))
+            area += static_cast<int64_t>(tile.width + AtlasPadding) * (tile.height + AtlasPadding);
+    }
+
+    auto size = OnDemandPageMinSize;
+    while (size < AtlasPageSize && (static_cast<int64_t>(size) * size < area || size < width || size < height))
+        size *= 2;
+    return size;
+}
+
+void DT1::uploadTile(DT1Tile &tile, DT1AtlasPage &page, const std::string_view path) {
+    if (tile.pixels.empty())
+        return;
+
+    if (!page.texture) {
+        page.texture.reset(Common::TextureTracker::createTexture(AbyssEngine::getInstance().getRenderer(), SDL_PIXELFORMAT_RGBA8888,
+                                                                 SDL_TEXTUREACCESS_STATIC, page.width, page.height, "DT1", path));
+        SDL_SetTextureBlendMode(page.texture.get(), SDL_BLENDMODE_BLEND);
+    }
+
+    SDL_UpdateTexture(page.texture.get(), &tile.atlasRect, tile.pixels.data(), tile.image.width * static_cast<int>(sizeof(uint32_t)));
+    tile.pixels = {};
+}
+
+void DT1::queueUpload() {
+    auto &uploadQueue = AbyssEngine::getInstance().getUploadQueue();
+    const std::weak_ptr tileSet = _tileSet;
+
+    for (const auto &tile : _tileSet->tiles) {
+        if (tile.page < 0 || tile.pixels.empty())
+            continue;
+
+        // The job may run after this DT1 was moved or destroyed, so it finds its tile by index through the tile set it holds weakly.
+        uploadQueue.push([tileSet, index = tile.dt1Index, path = name] {
+            if (const auto locked = tileSet.lock()) {
+                auto &queuedTile = locked->tiles[index];
+                uploadTile(queuedTile, locked->pages[queuedTile.page], path);
             }
+        });
+    }
+}
+
+void DT1::upload() {
+    for (auto &tile : _tileSet->tiles) {
+        if (tile.page >= 0)
+            uploadTile(tile, _tileSet->pages[tile.page], name);
+    }
+}
+
+void DT1::setPalette(const Palette &palette) {
+    _palette = palette;
+
+    std::vector<uint32_t> pixels;
+    for (auto &tile : _tileSet->tiles) {
+        if (tile.page < 0)
+            continue;
+
+        // Tiles still waiting in the upload queue only need their staged pixels refreshed.
+        if (!tile.pixels.empty()) {
+            tile.image.expand(palette, tile.pixels.data(), tile.image.width * static_cast<int>(sizeof(uint32_t)));
+            continue;
         }
 
-        SDL_UpdateTexture(currentTile.texture.get(), nullptr, pixels.data(), pitch);
+        pixels.resize(tile.image.indices.size());
+        const int pitch = tile.image.width * static_cast<int>(sizeof(uint32_t));
+        tile.image.expand(palette, pixels.data(), pitch);
+        SDL_UpdateTexture(_tileSet->pages[tile.page].texture.get(), &tile.atlasRect, pixels.data(), pitch);
     }
 }
 
 void DT1::drawTile(const int x, const int y, const int tileIndex) const {
-    if (tileIndex < 0 || tileIndex >= static_cast<int>(tiles.size()))
-        return;
-    const auto &tile = tiles.at(tileIndex);
-    const auto &renderer = AbyssEngine::getInstance().getRenderer();
-    const SDL_Rect destRect = {.x = x, .y = y - tile.drawOffsetY, .w = tile.width, .h = tile.height};
-    SDL_RenderCopy(renderer, tile.texture.get(), nullptr, &destRect);
+    SDL_Texture *texture;
+    SDL_Rect source;
+    SDL_Rect dest;
+    if (getTileSprite(x, y, tileIndex, texture, source, dest))
+        AbyssEngine::getInstance().getSpriteBatch().draw(texture, &source, dest);
 }
 
+bool DT1::getTileSprite(const int x, const int y, const int tileIndex, SDL_Texture *&texture, SDL_Rect &source, SDL_Rect &dest) const {
+    if (tileIndex < 0 || tileIndex >= static_cast<int>(_tileSet->tiles.size()))
+        return false;
+    auto &tile = _tileSet->tiles[tileIndex];
+    if (!tile.decoded)
+        decodeOnDemand(tile);
+    if (tile.page < 0 || !tile.pixels.empty())
+        return false;
+
+    texture = _tileSet->pages[tile.page].texture.get();
+    source = tile.atlasRect;
+    dest = {.x = x + tile.image.offsetX, .y = y - tile.drawOffsetY + tile.image.offsetY, .w = tile.image.width, .h = tile.image.height};
+    return true;
+}
+
+bool DT1::isTilePending(const int tileIndex) const {
+    if (tileIndex < 0 || tileIndex >= static_cast<int>(_tileSet->tiles.size()))
+        return false;
+    const auto &tile = _tileSet->tiles[tileIndex];
+    return tile.page >= 0 && !tile.pixels.empty();
+}
+
+const std::vector<DT1Tile> &DT1::getTiles() const { return _tileSet->tiles; }
+
+const std::string &DT1::getPath() const { return _path; }
+
+uint64_t DT1::getSourceHash() const { return _sourceHash; }
+
 } // namespace Abyss::DataTypes
@@ -1,10 +1,14 @@
 #pragma once
 
+#include "Abyss/Common/TextureTracker.h"
+#include "Abyss/DataTypes/IndexedImage.h"
 #include "Abyss/DataTypes/Palette.h"
+#include "Abyss/Streams/SpanReader.h"
 
 #include <SDL2/SDL.h>
 #include <cstdint>
 #include <memory>
+#include <span>
 #include <string_view>
 #include <vector>
 
@@ -101,19 +105,92 @@ struct DT1BlockHeader {
 
 struct DT1Tile {
     DT1TileHeader header{};
-    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture = {nullptr, SDL_DestroyTexture};
+    std::vector<DT1BlockHeader> blocks{};
+    // Pixels are decoded on demand; until then only the headers and block table are loaded.
+    bool decoded{};
+    IndexedImage image{};
+    // Palette-expanded pixels produced by the decoder, waiting for the texture upload. Released once the tile is in its atlas page.
+    std::vector<uint32_t> pixels{};
+    // Atlas page holding the tile, or -1 for tiles without any opaque pixels.
+    int page{-1};
+    SDL_Rect atlasRect{};
     int drawOffsetY{};
     int width{};
     int height{};
     int dt1Index{};
 };
 
+struct DT1AtlasPage {
+    std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture = {nullptr, Common::TextureTracker::destroy};
+    int width{};
+    int height{};
+};
+
+// A DT1's tiles and the atlas pages holding them. Shared, so queued uploads can hold them weakly: an upload whose DT1 is gone is dropped,
+// and one whose DT1 was moved still finds its tile.
+struct DT1TileSet {
+    std::vector<DT1Tile> tiles{};
+    std::vector<DT1AtlasPage> pages{};
+    // Shelf cursor into the page that tiles decoded on demand are packed into, one at a time, until it is full. -1 until the first one.
+    // The page is sized for the tiles that were not packed when it was created, not for a full atlas page.
+    struct {
+        int page{-1};
+        int x{};
+        int y{};
+        int height{};
+    } onDemandShelf{};
+};
+
+// Loading a DT1 only parses its tile headers and block tables; it does not touch the renderer and may run on a worker thread. Tile pixels
+// are decoded by prefetch(), normally for every tile a map references, and packed into atlas pages. The pages are created later on the
+// render thread, either all at once with upload() or spread over several frames with queueUpload(). A tile drawn before it was prefetched
+// is decoded and uploaded on the spot. Tiles that are decoded but not uploaded yet are not drawn.
 class DT1 {
+    static constexpr int AtlasPageSize = 2048;
+    static constexpr int OnDemandPageMinSize = 256;
+    static constexpr int AtlasPadding = 1;
+
+    std::string _path;
+    std::vector<std::byte> _fileData{};
+    // Hash of _fileData, computed once for the decode cache and map snapshots.
+    uint64_t _sourceHash{};
+    // Tiles decoded by an earlier run, from the decode cache. See DT1.cpp for the layout.
+    std::vector<std::byte> _cache{};
+    Palette _palette;
+    // Mutated by const members too, as drawTile() decodes tiles that were not prefetched.
+    std::shared_ptr<DT1TileSet> _tileSet;
+
+    static void readTileLayout(Streams::SpanReader &sr, DT1Tile &tile);
+    void decodeTile(DT1Tile &tile) const;
+    void decodeBlocks(DT1Tile &tile) const;
+    [[nodiscard]] bool isTileCached(uint32_t tileIndex) const;
+    bool loadCachedTile(DT1Tile &tile) const;
+    void storeCache() const;
+    void decodeOnDemand(DT1Tile &tile) const;
+    void packAtlas(std::span<const uint32_t> tileIndices) const;
+    void packOnDemand(DT1Tile &tile) const;
+    [[nodiscard]] int getOnDemandPageSize(int width, int height) const;
+    static void uploadTile(DT1Tile &tile, DT1AtlasPage &page, std::string_view path);
+
 public:
     std::string name;
-    std::vector<DT1Tile> tiles{};
     DT1(std::string_view path, const Palette &palette);
+    // Decodes the given tiles in parallel and packs them into new atlas pages. Tiles that are already decoded are skipped.
+    void prefetch(std::span<const uint32_t> tileIndices);
+    void prefetchAll();
+    void queueUpload();
+    void upload();
+    // Re-expands every decoded tile with a new palette. The tiles are not decoded again.
+    void setPalette(const Palette &palette);
     void drawTile(int x, int y, int tileIndex) const;
+    // Resolves what drawTile() would draw, without drawing it. Returns false for tiles drawTile() skips.
+    [[nodiscard]] bool getTileSprite(int x, int y, int tileIndex, SDL_Texture *&texture, SDL_Rect &source, SDL_Rect &dest) const;
+    // True while a tile is decoded but its atlas page is not uploaded yet, so drawTile() skips it.
+    [[nodiscard]] bool isTilePending(int tileIndex) const;
+    [[nodiscard]] const std::vector<DT1Tile> &getTiles() const;
+    [[nodiscard]] const std::string &getPath() const;
+    // Hash of the file the tiles were parsed from, so data derived from them can tell when it changed.
+    [[nodiscard]] uint64_t getSourceHash() const;
 };
 
 } // namespace Abyss::DataTypes
@@ -0,0 +1,57 @@
+#include "DT1TileIndex.h"
+
+namespace Abyss::DataTypes {
+
+DT1TileIndex::DT1TileIndex(const std::vector<DT1> &dt1s) {
+    for (const auto &dt1 : dt1s) {
+        for (const auto &tile : dt1.getTiles()) {
+            auto &variants = _variants[makeKey(tile.header.orientation, tile.header.mainIndex, tile.header.subIndex)];
+            const auto rarity = tile.header.animated ? 0 : tile.header.rarityOrFrameIndex;
+            variants.candidates.push_back({.dt1 = &dt1, .dt1Index = static_cast<uint32_t>(tile.dt1Index), .rarity = rarity});
+            variants.totalRarity += rarity;
+        }
+    }
+}
+
+uint64_t DT1TileIndex::makeKey(const TileType orientation, const uint32_t mainIndex, const uint32_t subIndex) {
+    return static_cast<uint64_t>(orientation) << 48 | static_cast<uint64_t>(mainIndex & 0xFFFFFF) << 24 | (subIndex & 0xFFFFFF);
+}
+
+const DT1TileVariants *DT1TileIndex::find(const TileType orientation, const uint32_t mainIndex, const uint32_t subIndex) const {
+    const auto it = _variants.find(makeKey(orientation, mainIndex, subIndex));
+    return it == _variants.end() ? nullptr : &it->second;
+}
+
+const DT1TileCandidate *DT1TileIndex::first(const TileType orientation, const uint32_t mainIndex, const uint32_t subIndex) const {
+    const auto *variants = find(orientation, mainIndex, subIndex);
+    return variants == nullptr ? nullptr : &variants->candidates.front();
+}
+
+const DT1TileCandidate *DT1TileIndex::selectWeighted(const TileType orientation, const uint32_t mainIndex, const uint32_t subIndex,
+                                                     uint32_t seed) const {
+    const auto *variants = find(orientation, mainIndex, subIndex);
+    if (variants == nullptr)
+        return nullptr;
+
+    const auto &candidates = variants->candidates;
+    if (candidates.size() == 1 || variants->totalRarity == 0)
+        return &candidates.front();
+
+    // Integer hash so neighbouring cells do not pick correlated variants.
+    seed ^= seed >> 16;
+    seed *= 0x7FEB352D;
+    seed ^= seed >> 15;
+    seed *= 0x846CA68B;
+    seed ^= seed >> 16;
+
+    auto roll = seed % variants->totalRarity;
+    for (const auto &candidate : candidates) {
+        if (roll < candidate.rarity)
+            return &candidate;
+        roll -= candidate.rarity;
+    }
+
+    return &candidates.front();
+}
+
+} // namespace Abyss::DataTypes
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "DT1.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <cstdint>
+#include <vector>
+
+namespace Abyss::DataTypes {
+
+struct DT1TileCandidate {
+    const DT1 *dt1{};
+    uint32_t dt1Index{};
+    uint32_t rarity{};
+};
+
+struct DT1TileVariants {
+    // In DT1 load order, then tile order, so the first candidate is the tile a plain linear search would find.
+    std::vector<DT1TileCandidate> candidates{};
+    uint32_t totalRarity{};
+};
+
+// Maps (orientation, main index, sub index) to every tile in a DT1 set that matches it. Built once per set of DT1s, so binding a map is a
+// hash lookup per cell instead of a scan over every tile. The index points into the DT1s, which must outlive it and must not move.
+class DT1TileIndex {
+    absl::flat_hash_map<uint64_t, DT1TileVariants> _variants{};
+
+    [[nodiscard]] static uint64_t makeKey(TileType orientation, uint32_t mainIndex, uint32_t subIndex);
+
+  public:
+    DT1TileIndex() = default;
+    explicit DT1TileIndex(const std::vector<DT1> &dt1s);
+
+    [[nodiscard]] const DT1TileVariants *find(TileType orientation, uint32_t mainIndex, uint32_t subIndex) const;
+
+    // Returns the first matching tile, the one a linear search over the DT1s finds.
+    [[nodiscard]] const DT1TileCandidate *first(TileType orientation, uint32_t mainIndex, uint32_t subIndex) const;
+
+    // Picks a variant weighted by tile rarity. The same seed always yields the same tile, so a map looks identical on every load. Animated
+    // tiles store a frame index instead of a rarity and always resolve to their first candidate.
+    [[nodiscard]] const DT1TileCandidate *selectWeighted(TileType orientation, uint32_t mainIndex, uint32_t subIndex, uint32_t seed) const;
+};
+
+} // namespace Abyss::DataTypes
@@ -0,0 +1,89 @@
+#include "IndexedImage.h"
+#include "Abyss/Common/PixelKernels.h"
+
+#include <algorithm>
+#include <iterator>
+
+namespace Abyss::DataTypes {
+
+IndexedImage::IndexedImage(const int width, const int height, const bool masked)
+    : width(width), height(height), indices(static_cast<size_t>(width) * height) {
+    if (masked)
+        mask.resize(indices.size());
+}
+
+bool IndexedImage::empty() const { return indices.empty(); }
+
+void IndexedImage::clear() {
+    width = 0;
+    height = 0;
+    offsetX = 0;
+    offsetY = 0;
+    indices = {};
+    mask = {};
+}
+
+void IndexedImage::trim() {
+    const auto &opacity = mask.empty() ? indices : mask;
+    auto minX = width;
+    auto minY = height;
+    auto maxX = -1;
+    auto maxY = -1;
+
+    for (auto y = 0; y < height; y++) {
+        const auto *row = opacity.data() + static_cast<size_t>(y) * width;
+        const auto *first = std::find_if(row, row + width, [](const uint8_t value) { return value != 0; });
+        if (first == row + width)
+            continue;
+
+        const auto *last = std::find_if(std::make_reverse_iterator(row + width), std::make_reverse_iterator(row), [](const uint8_t value) {
+                               return value != 0;
+                           }).base() - 1;
+
+        minX = std::min(minX, static_cast<int>(first - row));
+        maxX = std::max(maxX, static_cast<int>(last - row));
+        minY = std::min(minY, y);
+        maxY = y;
+    }
+
+    if (maxY < 0) {
+        clear();
+        return;
+    }
+
+    if (minX == 0 && minY == 0 && maxX == width - 1 && maxY == height - 1)
+        return;
+
+    const auto trimmedWidth = maxX - minX + 1;
+    const auto trimmedHeight = maxY - minY + 1;
+    auto crop = [&](const std::vector<uint8_t> &source) {
+        std::vector<uint8_t> result(static_cast<size_t>(trimmedWidth) * trimmedHeight);
+        for (auto y = 0; y < trimmedHeight; y++) {
+            const auto *row = source.data() + static_cast<size_t>(minY + y) * width + minX;
+            std::copy_n(row, trimmedWidth, result.data() + static_cast<size_t>(y) * trimmedWidth);
+        }
+        return result;
+    };
+
+    indices = crop(indices);
+    if (!mask.empty())
+        mask = crop(mask);
+
+    width = trimmedWidth;
+    height = trimmedHeight;
+    offsetX += minX;
+    offsetY += minY;
+}
+
+void IndexedImage::expand(const Palette &palette, uint32_t *pixels, const int pitch) const {
+    const auto &lut = palette.getRgbaLookup();
+    const auto stride = pitch / static_cast<int>(sizeof(uint32_t));
+
+    for (auto y = 0; y < height; y++) {
+        const auto rowOffset = static_cast<size_t>(y) * width;
+        Common::PixelKernels::expandIndexed(indices.data() + rowOffset, mask.empty() ? nullptr : mask.data() + rowOffset,
+                                            pixels + static_cast<size_t>(y) * stride, width, lut.data());
+    }
+}
+
+} // namespace Abyss::DataTypes
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Palette.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace Abyss::DataTypes {
+
+// A decoded 8-bit palettized image. Keeping sprites in this form lets a palette change re-expand the pixels with a 256 entry lookup instead of
+// decoding the source data again.
+struct IndexedImage {
+    int width{};
+    int height{};
+    // Position of this image inside the untrimmed source rectangle; non-zero after trim().
+    int offsetX{};
+    int offsetY{};
+    std::vector<uint8_t> indices{};
+    // One byte per pixel, non-zero when the pixel is opaque. When empty, palette index 0 is treated as transparent instead.
+    std::vector<uint8_t> mask{};
+
+    IndexedImage() = default;
+    IndexedImage(int width, int height, bool masked);
+    [[nodiscard]] bool empty() const;
+    void clear();
+    // Crops the image to the bounds of its opaque pixels, accumulating the removed margin in offsetX/offsetY. A fully transparent image
+    // becomes empty.
+    void trim();
+
+    // Expands the image to RGBA8888 using the palette's lookup table. `pitch` is in bytes.
+    void expand(const Palette &palette, uint32_t *pixels, int pitch) const;
+};
+
+} // namespace Abyss::DataTypes
@@ -46,7 +46,14 @@ size_t Palette::getEntryCount() const { return _entries.size(); }
 
 SDL_Color Palette::getSdlColor(const size_t index) const { return index == 0 ? SDL_Color{0, 0, 0, 0} : getEntry(index).getSdlColor(); }
 
-void Palette::addEntry(const PaletteEntry entry) { _entries.push_back(entry); }
+const std::array<uint32_t, 256> &Palette::getRgbaLookup() const { return _rgbaLookup; }
+
+void Palette::addEntry(const PaletteEntry entry) {
+    if (_entries.size() < _rgbaLookup.size())
+        _rgbaLookup[_entries.size()] = static_cast<uint32_t>(entry.getBlue() << 24 | entry.getGreen() << 16 | entry.getRed() << 8 | 0xFF);
+
+    _entries.push_back(entry);
+}
 
 void Palette::addEntries(const std::vector<PaletteEntry> &newEntries) {
     for (const auto &entry : newEntries) {
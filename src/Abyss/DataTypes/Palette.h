@@ -1,6 +1,7 @@
 #pragma once
 
 #include <SDL2/SDL.h>
+#include <array>
 #include <string>
 #include <vector>
 #include <cstdint>
@@ -22,6 +23,7 @@ public:
 
 class Palette {
     std::vector<PaletteEntry> _entries{};
+    std::array<uint32_t, 256> _rgbaLookup{};
     std::string _name;
     static uint8_t colorAdjust(uint8_t value);
     inline static float gamma{1.2f};
@@ -36,6 +38,8 @@ public:
     [[nodiscard]] const std::vector<PaletteEntry> &getEntries() const;
     [[nodiscard]] size_t getEntryCount() const;
     [[nodiscard]] SDL_Color getSdlColor(size_t index) const;
+    // Opaque RGBA8888 texel for every palette index, used to expand indexed images.
+    [[nodiscard]] const std::array<uint32_t, 256> &getRgbaLookup() const;
     void addEntry(PaletteEntry entry);
     void addEntries(const std::vector<PaletteEntry> &newEntries);
 };
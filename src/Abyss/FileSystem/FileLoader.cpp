@@ -24,6 +24,7 @@ std::vector<std::string> FileLoader::loadStringList(std::string_view path) {
 }
 
 std::vector<std::byte> FileLoader::loadBytes(std::string_view path) {
+    std::lock_guard lock(_readMutex);
     auto stream = loadFile(path);
     std::vector<std::byte> result;
     result.resize(stream.size());
@@ -4,6 +4,7 @@
 #include "Provider.h"
 
 #include <absl/container/flat_hash_map.h>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -11,6 +12,9 @@
 namespace Abyss::FileSystem {
 
 class FileLoader {
+    // Archive streams are read lazily and are not safe to read from several threads, so whole-file reads are serialized.
+    std::mutex _readMutex;
+
   public:
     virtual ~FileLoader() = default;
 
@@ -0,0 +1,118 @@
+#include "CollisionGrid.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Abyss::MapEngine {
+
+namespace {
+
+// DT1 subtile flag bits that block each plane, in CollisionPlane order.
+constexpr std::array<uint8_t, 4> PlaneFlags = {
+    static_cast<uint8_t>(DataTypes::DT1SubtileFlag::BlockWalk),
+    static_cast<uint8_t>(DataTypes::DT1SubtileFlag::BlockLightBlockLOS),
+    static_cast<uint8_t>(DataTypes::DT1SubtileFlag::BlockJump),
+    static_cast<uint8_t>(static_cast<uint8_t>(DataTypes::DT1SubtileFlag::BlockLightBlockLOS) |
+                         static_cast<uint8_t>(DataTypes::DT1SubtileFlag::BlockLightOnlyNotLOS)),
+};
+
+// Mask of the bits of `word` that fall inside [x0, x1).
+uint64_t spanMask(const size_t word, const int x0, const int x1) {
+    const auto first = static_cast<int>(word * 64);
+    auto mask = ~uint64_t{0};
+    if (x0 > first)
+        mask &= ~uint64_t{0} << (x0 - first);
+    if (x1 < first + 64)
+        mask &= (uint64_t{1} << (x1 - first)) - 1;
+    return mask;
+}
+
+} // namespace
+
+CollisionGrid::CollisionGrid(const int tileWidth, const int tileHeight)
+    : _width(tileWidth * SubtilesPerTile), _height(tileHeight * SubtilesPerTile), _wordsPerRow((static_cast<size_t>(_width) + 63) / 64) {
+    for (auto &plane : _planes)
+        plane.assign(_wordsPerRow * _height, 0);
+}
+
+int CollisionGrid::getWidth() const { return _width; }
+
+int CollisionGrid::getHeight() const { return _height; }
+
+void CollisionGrid::setBit(const CollisionPlane plane, const int x, const int y, const bool blocked) {
+    auto &word = _planes[static_cast<size_t>(plane)][static_cast<size_t>(y) * _wordsPerRow + x / 64];
+    const auto bit = uint64_t{1} << (x % 64);
+    word = blocked ? word | bit : word & ~bit;
+}
+
+void CollisionGrid::clearTile(const int tileX, const int tileY) {
+    for (auto plane = 0u; plane < PlaneCount; plane++) {
+        for (auto subY = 0; subY < SubtilesPerTile; subY++) {
+            for (auto subX = 0; subX < SubtilesPerTile; subX++)
+                setBit(static_cast<CollisionPlane>(plane), tileX * SubtilesPerTile + subX, tileY * SubtilesPerTile + subY, false);
+        }
+    }
+}
+
+void CollisionGrid::addTile(const int tileX, const int tileY, const DataTypes::DT1TileHeader &header) {
+    // Subtile flags are stored row by row, 5 per row.
+    for (auto subY = 0; subY < SubtilesPerTile; subY++) {
+        for (auto subX = 0; subX < SubtilesPerTile; subX++) {
+            const auto flags = static_cast<uint8_t>(header.subtileFlags[subY * SubtilesPerTile + subX]);
+            if (flags == 0)
+                continue;
+
+            for (auto plane = 0u; plane < PlaneCount; plane++) {
+                if (flags & PlaneFlags[plane])
+                    setBit(static_cast<CollisionPlane>(plane), tileX * SubtilesPerTile + subX, tileY * SubtilesPerTile + subY, true);
+            }
+        }
+    }
+}
+
+bool CollisionGrid::isBlocked(const CollisionPlane plane, const int x, const int y) const {
+    if (x < 0 || y < 0 || x >= _width || y >= _height)
+        return true;
+
+    const auto word = _planes[static_cast<size_t>(plane)][static_cast<size_t>(y) * _wordsPerRow + x / 64];
+    return (word >> (x % 64)) & 1;
+}
+
+bool CollisionGrid::isWalkable(const int x, const int y) const { return !isBlocked(CollisionPlane::Walk, x, y); }
+
+int CollisionGrid::findFirstBlocked(const CollisionPlane plane, const int y, int x0, int x1) const {
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, _width);
+    if (y < 0 || y >= _height || x0 >= x1)
+        return -1;
+
+    const auto row = getRow(plane, y);
+    for (auto word = static_cast<size_t>(x0 / 64); word <= static_cast<size_t>((x1 - 1) / 64); word++) {
+        if (const auto bits = row[word] & spanMask(word, x0, x1); bits != 0)
+            return static_cast<int>(word * 64) + std::countr_zero(bits);
+    }
+    return -1;
+}
+
+int CollisionGrid::countBlocked(const CollisionPlane plane, const int y, int x0, int x1) const {
+    x0 = std::max(x0, 0);
+    x1 = std::min(x1, _width);
+    if (y < 0 || y >= _height || x0 >= x1)
+        return 0;
+
+    const auto row = getRow(plane, y);
+    auto count = 0;
+    for (auto word = static_cast<size_t>(x0 / 64); word <= static_cast<size_t>((x1 - 1) / 64); word++)
+        count += std::popcount(row[word] & spanMask(word, x0, x1));
+    return count;
+}
+
+std::span<const uint64_t> CollisionGrid::getRow(const CollisionPlane plane, const int y) const {
+    return {_planes[static_cast<size_t>(plane)].data() + static_cast<size_t>(y) * _wordsPerRow, _wordsPerRow};
+}
+
+std::span<const uint64_t> CollisionGrid::getPlane(const CollisionPlane plane) const { return _planes[static_cast<size_t>(plane)]; }
+
+std::span<uint64_t> CollisionGrid::getPlane(const CollisionPlane plane) { return _planes[static_cast<size_t>(plane)]; }
+
+} // namespace Abyss::MapEngine
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Abyss/DataTypes/DT1.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Abyss::MapEngine {
+
+enum class CollisionPlane : uint8_t { Walk, LineOfSight, Jump, Light };
+
+// Per-subtile blocking flags for a whole map, 5x5 subtiles per tile. Each plane is a bitmap with one bit per subtile (set means blocked) and
+// rows padded to whole 64-bit words, so a row of a 200 tile wide map is 16 words and a full plane of it fits in L2. Row scans test 64
+// subtiles per step.
+class CollisionGrid {
+    static constexpr size_t PlaneCount = 4;
+
+    int _width{};
+    int _height{};
+    size_t _wordsPerRow{};
+    std::array<std::vector<uint64_t>, PlaneCount> _planes{};
+
+    void setBit(CollisionPlane plane, int x, int y, bool blocked);
+
+  public:
+    static constexpr int SubtilesPerTile = 5;
+
+    CollisionGrid() = default;
+    CollisionGrid(int tileWidth, int tileHeight);
+
+    // Width and height in subtiles.
+    [[nodiscard]] int getWidth() const;
+    [[nodiscard]] int getHeight() const;
+
+    void clearTile(int tileX, int tileY);
+    // Adds the blocking flags of a DT1 tile to the tile's subtiles. Several tiles on one cell (floors, walls) accumulate.
+    void addTile(int tileX, int tileY, const DataTypes::DT1TileHeader &header);
+
+    // Subtiles outside the map are blocked.
+    [[nodiscard]] bool isBlocked(CollisionPlane plane, int x, int y) const;
+    [[nodiscard]] bool isWalkable(int x, int y) const;
+
+    // First blocked subtile in [x0, x1) on row y, or -1 when the span is clear.
+    [[nodiscard]] int findFirstBlocked(CollisionPlane plane, int y, int x0, int x1) const;
+    [[nodiscard]] int countBlocked(CollisionPlane plane, int y, int x0, int x1) const;
+    [[nodiscard]] std::span<const uint64_t> getRow(CollisionPlane plane, int y) const;
+    // Every row of a plane, for saving and restoring map snapshots.
+    [[nodiscard]] std::span<const uint64_t> getPlane(CollisionPlane plane) const;
+    [[nodiscard]] std::span<uint64_t> getPlane(CollisionPlane plane);
+};
+
+} // namespace Abyss::MapEngine
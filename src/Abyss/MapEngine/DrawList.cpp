@@ -0,0 +1,84 @@
+#include "DrawList.h"
+
+#include "Abyss/AbyssEngine.h"
+
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <utility>
+
+namespace Abyss::MapEngine {
+
+namespace {
+
+// Sort key: the layer in the top 4 bits, the biased depth below it.
+constexpr int DepthBits = 28;
+constexpr int64_t DepthBias = int64_t{1} << (DepthBits - 1);
+constexpr uint32_t DepthMask = (uint32_t{1} << DepthBits) - 1;
+
+uint32_t makeKey(const DrawLayer layer, const int depth) {
+    const auto biasedDepth = std::clamp<int64_t>(depth + DepthBias, 0, DepthMask);
+    return static_cast<uint32_t>(layer) << DepthBits | static_cast<uint32_t>(biasedDepth);
+}
+
+} // namespace
+
+void DrawList::add(const DrawLayer layer, const int depth, SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &dest) {
+    _entries.push_back({.texture = texture, .source = source ? *source : SDL_Rect{}, .dest = dest, .hasSource = source != nullptr});
+    _keys.push_back(makeKey(layer, depth));
+}
+
+bool DrawList::isOrderSorted() const {
+    for (size_t i = 1; i < _order.size(); i++) {
+        const auto previous = _order[i - 1];
+        const auto current = _order[i];
+        if (_keys[previous] > _keys[current] || (_keys[previous] == _keys[current] && previous > current))
+            return false;
+    }
+    return true;
+}
+
+void DrawList::sort() {
+    const auto count = _keys.size();
+    if (_order.size() == count && isOrderSorted())
+        return;
+
+    // LSD radix sort of the entry indices, one byte of the key per pass. Each pass is stable, so equal keys keep the order they were added in.
+    // Passes where every key has the same byte, such as the layer byte when only walls are queued, are skipped.
+    _order.resize(count);
+    std::iota(_order.begin(), _order.end(), 0u);
+    _scratch.resize(count);
+
+    for (auto shift = 0; shift < 32 && count > 1; shift += 8) {
+        std::array<uint32_t, 256> offsets{};
+        for (const auto key : _keys)
+            ++offsets[(key >> shift) & 0xFF];
+        if (offsets[(_keys[0] >> shift) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (auto &bucket : offsets)
+            bucket = std::exchange(offset, offset + bucket);
+
+        for (const auto index : _order)
+            _scratch[offsets[(_keys[index] >> shift) & 0xFF]++] = index;
+        _order.swap(_scratch);
+    }
+}
+
+void DrawList::draw() const {
+    auto &spriteBatch = AbyssEngine::getInstance().getSpriteBatch();
+    for (const auto index : _order) {
+        const auto &entry = _entries[index];
+        spriteBatch.draw(entry.texture, entry.hasSource ? &entry.source : nullptr, entry.dest);
+    }
+}
+
+void DrawList::clear() {
+    _entries.clear();
+    _keys.clear();
+}
+
+size_t DrawList::size() const { return _entries.size(); }
+
+} // namespace Abyss::MapEngine
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <vector>
+
+namespace Abyss::MapEngine {
+
+// Layers draw in this order; within a layer, drawables draw back to front by depth.
+enum class DrawLayer : uint8_t {
+    LowerWalls,
+    Floors,
+    // Upper walls and everything standing among them: objects, units, missiles.
+    Walls,
+    Roofs,
+};
+
+// One frame's worth of map drawables. Everything is added first, then sorted by (layer, depth) and submitted to the sprite batch in a
+// single pass, so units and objects interleave correctly with walls. Drawables with the same layer and depth keep the order they were
+// added in.
+class DrawList {
+    struct Entry {
+        SDL_Texture *texture{};
+        SDL_Rect source{};
+        SDL_Rect dest{};
+        bool hasSource{};
+    };
+
+    std::vector<Entry> _entries{};
+    std::vector<uint32_t> _keys{};
+    // Indices into _entries in draw order. Kept across frames: when the same number of drawables comes back in the same order, the previous
+    // order is still sorted and the radix passes are skipped.
+    std::vector<uint32_t> _order{};
+    std::vector<uint32_t> _scratch{};
+
+    [[nodiscard]] bool isOrderSorted() const;
+
+  public:
+    // `depth` is the screen y of the drawable's foot in map pixels ((tileX + tileY) * 40 for a cell), so anything further down the screen
+    // draws in front. `source` may be null to draw the whole texture.
+    void add(DrawLayer layer, int depth, SDL_Texture *texture, const SDL_Rect *source, const SDL_Rect &dest);
+    void sort();
+    // Submits the sorted drawables to the sprite batch.
+    void draw() const;
+    void clear();
+    [[nodiscard]] size_t size() const;
+};
+
+} // namespace Abyss::MapEngine
@@ -0,0 +1,124 @@
+#include "LevelLoader.h"
+
+#include "Abyss/AbyssEngine.h"
+#include "Abyss/Common/Logging.h"
+
+#include <absl/container/flat_hash_set.h>
+#include <absl/strings/str_replace.h>
+#include <algorithm>
+#include <exception>
+#include <future>
+
+namespace Abyss::MapEngine {
+
+namespace {
+
+constexpr std::string_view MapSnapshotKind = "map";
+
+// Waits for every future, even after one has thrown, so no job outlives the data it references. The first error is kept in `error`.
+template <typename Result>
+std::vector<Result> waitAll(Common::ThreadPool &threadPool, std::vector<std::future<Result>> &futures, std::exception_ptr &error) {
+    std::vector<Result> results;
+    results.reserve(futures.size());
+    for (auto &future : futures) {
+        try {
+            results.push_back(threadPool.wait(future));
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+    return results;
+}
+
+} // namespace
+
+std::string normalizeTilePath(std::string path) {
+    std::ranges::replace(path, '\\', '/');
+    std::ranges::transform(path, path.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (path.starts_with("/d2/")) // Because why not?
+        path = path.substr(3);
+    absl::StrReplaceAll({{".tg1", ".dt1"}}, &path); // Replace tg1 with dt1 because blizzard
+    absl::StrReplaceAll({{".ds1", ".dt1"}}, &path); // Why yes, this is also a thing....
+    return path;
+}
+
+LevelFiles loadLevelFiles(const std::span<const std::string> ds1Paths, const std::span<const std::string> dt1Paths,
+                          const DataTypes::Palette &palette) {
+    auto &threadPool = AbyssEngine::getInstance().getThreadPool();
+
+    std::vector<std::future<DataTypes::DS1>> ds1Futures;
+    ds1Futures.reserve(ds1Paths.size());
+    for (const auto &path : ds1Paths)
+        ds1Futures.emplace_back(threadPool.submit([path] { return DataTypes::DS1(path); }));
+
+    absl::flat_hash_set<std::string> requested;
+    std::vector<std::future<DataTypes::DT1>> dt1Futures;
+    const auto requestDt1 = [&](std::string path) {
+        path = normalizeTilePath(std::move(path));
+        if (requested.insert(path).second)
+            dt1Futures.emplace_back(threadPool.submit([path, &palette] { return DataTypes::DT1(path, palette); }));
+    };
+
+    for (const auto &path : dt1Paths)
+        requestDt1(path);
+
+    std::exception_ptr error;
+    LevelFiles level;
+    level.ds1s = waitAll(threadPool, ds1Futures, error);
+
+    if (!error) {
+        for (const auto &ds1 : level.ds1s) {
+            for (const auto &file : ds1.files)
+                requestDt1(file);
+        }
+    }
+
+    level.dt1s = waitAll(threadPool, dt1Futures, error);
+    if (error)
+        std::rethrow_exception(error);
+
+    return level;
+}
+
+std::unique_ptr<MapEngine> loadLevel(const std::string &ds1Path, const std::span<const std::string> dt1Paths, const DataTypes::Palette &palette) {
+    auto &engine = AbyssEngine::getInstance();
+    const auto &decodeCache = engine.getDecodeCache();
+    const auto ds1Bytes = engine.loadBytes(ds1Path);
+
+    // The snapshot records the hash of every DT1 it was built from and checks them itself; the key covers the rest of the inputs. Paths
+    // are NUL-terminated so different lists never join into the same bytes.
+    auto snapshotSource = ds1Bytes;
+    for (const auto &path : dt1Paths) {
+        const auto bytes = std::as_bytes(std::span(path.c_str(), path.size() + 1));
+        snapshotSource.insert(snapshotSource.end(), bytes.begin(), bytes.end());
+    }
+
+    if (const auto snapshot = decodeCache.load(ds1Path, MapSnapshotKind, MapEngine::SnapshotVersion, snapshotSource)) {
+        try {
+            if (auto map = MapEngine::loadSnapshot(*snapshot, palette)) {
+                map->prefetchTiles();
+                return map;
+            }
+        } catch (const std::exception &exception) {
+            Common::Log::warn("Ignoring map snapshot for {}: {}", ds1Path, exception.what());
+        }
+    }
+
+    // The DS1 is parsed from the bytes read for the key, and its DT1s are loaded along with `dt1Paths`.
+    std::vector<DataTypes::DS1> ds1s;
+    ds1s.emplace_back(ds1Path, ds1Bytes);
+    std::vector<std::string> allDt1Paths(dt1Paths.begin(), dt1Paths.end());
+    allDt1Paths.insert(allDt1Paths.end(), ds1s.front().files.begin(), ds1s.front().files.end());
+    auto level = loadLevelFiles({}, allDt1Paths, palette);
+
+    const auto width = ds1s.front().width;
+    const auto height = ds1s.front().height;
+    auto map = std::make_unique<MapEngine>(width, height, std::move(level.dt1s), std::move(ds1s));
+    map->stampDs1(0, 0, 0);
+    decodeCache.store(ds1Path, MapSnapshotKind, MapEngine::SnapshotVersion, snapshotSource, map->saveSnapshot());
+    map->prefetchTiles();
+    return map;
+}
+
+} // namespace Abyss::MapEngine
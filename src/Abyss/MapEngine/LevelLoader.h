@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Abyss/DataTypes/DS1.h"
+#include "Abyss/DataTypes/DT1.h"
+#include "Abyss/DataTypes/Palette.h"
+#include "MapEngine.h"
+
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Abyss::MapEngine {
+
+// The parsed files a level is assembled from, ready to hand to MapEngine.
+struct LevelFiles {
+    std::vector<DataTypes::DT1> dt1s{};
+    std::vector<DataTypes::DS1> ds1s{};
+};
+
+// Turns a DT1 path as listed in a DS1 (backslashes, "\d2\" prefix, .tg1/.ds1 extensions) into a lowercase MPQ path.
+[[nodiscard]] std::string normalizeTilePath(std::string path);
+
+// Parses every DS1 of a level concurrently on the engine's thread pool, then loads the deduplicated union of `dt1Paths` and the DT1s the
+// DS1s reference, also in parallel. The DT1s listed in `dt1Paths` start loading alongside the DS1s, so a level costs roughly its slowest file.
+[[nodiscard]] LevelFiles loadLevelFiles(std::span<const std::string> ds1Paths, std::span<const std::string> dt1Paths,
+                                        const DataTypes::Palette &palette);
+
+// Loads a level made of one DS1 stamped at the origin, with `dt1Paths` in addition to the DT1s the DS1 lists, and prefetches its tiles.
+// The assembled map is kept as a snapshot in the decode cache, keyed by the DS1 bytes and `dt1Paths`. Loading the same level again
+// restores the snapshot, so only the DT1s are loaded; the DS1 is neither parsed nor bound nor stamped.
+[[nodiscard]] std::unique_ptr<MapEngine> loadLevel(const std::string &ds1Path, std::span<const std::string> dt1Paths,
+                                                   const DataTypes::Palette &palette);
+
+} // namespace Abyss::MapEngine
@@ -1,22 +1,128 @@
 #include "MapEngine.h"
 
-#include "Abyss/AbyssEngine.h"
+#include "LevelLoader.h"
 
+#include "Abyss/AbyssEngine.h"
+#include "Abyss/Streams/SpanReader.h"
+
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_cat.h>
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <exception>
 #include <future>
+#include <limits>
+#include <stdexcept>
 
 namespace Abyss::MapEngine {
+
+namespace {
+
+// Size of the render target the map is drawn to.
+constexpr int ViewWidth = 800;
+constexpr int ViewHeight = 600;
+constexpr int TileWidth = 160;
+// Where the upper wall and roof passes draw relative to a cell's floor position.
+constexpr int UpperWallOffsetY = 96;
+constexpr int RoofOffsetY = -72;
+
+int floorDiv(const int value, const int divisor) { return value / divisor - (value % divisor != 0 && (value < 0) != (divisor < 0)); }
+
+// Snapshot payload: a SnapshotHeader, the DT1 manifest (per DT1 its source hash, path length and path), one SnapshotTile per tile id, the
+// dense floor layers, the sparse wall, shadow and substitution layers row by row (occupancy words, then the ids of the occupied cells), and
+// the collision planes. Snapshots live in the local decode cache, so values are stored in host byte order and copied in bulk.
+constexpr uint32_t NoDt1 = ~uint32_t{0};
+constexpr std::array CollisionPlanes = {CollisionPlane::Walk, CollisionPlane::LineOfSight, CollisionPlane::Jump, CollisionPlane::Light};
+
+struct SnapshotHeader {
+    int32_t width{};
+    int32_t height{};
+    uint32_t dt1Count{};
+    uint32_t tileCount{};
+    // Floor, wall, shadow and substitution.
+    std::array<uint32_t, 4> layerCounts{};
+};
+
+struct SnapshotTile {
+    uint32_t dt1{};
+    uint32_t dt1Index{};
+    uint32_t dt1IndexAlt{};
+    uint32_t type{};
+};
+
+template <typename Range> void writeValues(std::vector<std::byte> &out, const Range &values) {
+    const auto bytes = std::as_bytes(std::span(values));
+    out.insert(out.end(), bytes.begin(), bytes.end());
+}
+
+template <typename Range> void readValues(Streams::SpanReader &sr, Range &&values) { sr.readBytes(std::as_writable_bytes(std::span(values))); }
+
+void writeSparseLayer(std::vector<std::byte> &out, const SparseTileLayer &layer, const int height) {
+    std::vector<DataTypes::TileId> ids;
+    for (auto y = 0; y < height; ++y) {
+        ids.clear();
+        layer.forEachInRow(y, [&ids](int, const DataTypes::TileId id) { ids.push_back(id); });
+        writeValues(out, layer.getOccupancy(y));
+        writeValues(out, ids);
+    }
+}
+
+void readSparseLayer(Streams::SpanReader &sr, SparseTileLayer &layer, const int width, const int height, const size_t tileCount) {
+    std::vector<uint64_t> occupancy((width + 63) / 64);
+    std::vector<DataTypes::TileId> ids;
+    DataTypes::TileLayer row(width);
+    for (auto y = 0; y < height; ++y) {
+        readValues(sr, occupancy);
+        size_t count = 0;
+        for (const auto word : occupancy)
+            count += std::popcount(word);
+        ids.resize(count);
+        readValues(sr, ids);
+
+        std::ranges::fill(row, 0);
+        const auto *id = ids.data();
+        for (size_t word = 0; word < occupancy.size(); ++word) {
+            for (auto bits = occupancy[word]; bits != 0; bits &= bits - 1) {
+                const auto x = static_cast<int>(word * 64) + std::countr_zero(bits);
+                if (x >= width || *id >= tileCount)
+                    throw std::runtime_error("Malformed map snapshot");
+                row[x] = *id++;
+            }
+        }
+        layer.writeRow(y, 0, row);
+    }
+}
+
+} // namespace
+
 MapEngine::MapEngine(const int width, const int height, std::vector<DataTypes::DT1> dt1s, std::vector<DataTypes::DS1> ds1s)
-    : _width(width), _height(height), _dt1s(std::move(dt1s)), _ds1s(std::move(ds1s)) {
+    : _width(width), _height(height), _dt1s(std::move(dt1s)), _ds1s(std::move(ds1s)), _tileIndex(_dt1s), _collision(width, height) {
 
+    // Every DS1 binds against the one tile index built over the shared DT1 set.
+    auto &threadPool = AbyssEngine::getInstance().getThreadPool();
     std::vector<std::future<void>> futures;
-
     futures.reserve(_ds1s.size());
-
     for (auto &ds1 : _ds1s)
-        futures.emplace_back(std::async(std::launch::async, [&ds1, this]() { ds1.bindTileReferences(_dt1s); }));
+        futures.emplace_back(threadPool.submit([&ds1, this] { ds1.bindTileReferences(_tileIndex); }));
+
+    std::exception_ptr error;
+    for (auto &future : futures) {
+        try {
+            threadPool.wait(future);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
 
-    for (auto &future : futures)
-        future.wait();
+    for (const auto &dt1 : _dt1s) {
+        for (const auto &tile : dt1.getTiles()) {
+            _tileExtentAbove = std::max(_tileExtentAbove, tile.drawOffsetY);
+            _tileExtentBelow = std::max(_tileExtentBelow, tile.height - tile.drawOffsetY);
+        }
+    }
 
     auto maxFloors = 0;
     auto maxWalls = 0;
@@ -39,11 +145,15 @@ MapEngine::MapEngine(const int width, const int height, std::vector<DataTypes::D
     for (auto &layer : _layers.floor)
         layer.resize(cellCount);
     for (auto &layer : _layers.wall)
-        layer.resize(cellCount);
+        layer = SparseTileLayer(_width, _height);
     for (auto &layer : _layers.shadow)
-        layer.resize(cellCount);
+        layer = SparseTileLayer(_width, _height);
     for (auto &layer : _layers.substitution)
-        layer.resize(cellCount);
+        layer = SparseTileLayer(_width, _height);
+
+    _chunksWide = (_width + ChunkSize - 1) / ChunkSize;
+    _chunksHigh = (_height + ChunkSize - 1) / ChunkSize;
+    _floorChunks.resize(static_cast<size_t>(_chunksWide) * _chunksHigh);
 }
 
 void MapEngine::stampDs1(const uint32_t ds1Index, const int originX, const int originY) {
@@ -51,124 +161,389 @@ void MapEngine::stampDs1(const uint32_t ds1Index, const int originX, const int o
     const auto ds1Width = ds1.width;
     const auto ds1Height = ds1.height;
 
-    // Block copy all layers of the specific DS1 to the specified location on the map
-    for (auto y = 0; y < ds1Height; ++y) {
-        for (auto x = 0; x < ds1Width; ++x) {
-            // Floors
-            for (auto layerIdx = 0; layerIdx < ds1.layers.floor.size(); ++layerIdx) {
-                const auto &tile = ds1.layers.floor[layerIdx][y * ds1Width + x];
-                const auto mapX = originX + x;
-                const auto mapY = originY + y;
-                if (mapX < 0 || mapX >= _width || mapY < 0 || mapY >= _height)
-                    continue;
-                _layers.floor[layerIdx][mapY * _width + mapX] = tile;
+    // Map the DS1's tile ids onto this map's tile table once, then copy each layer row by row.
+    std::vector<DataTypes::TileId> remap(ds1.tileTable.size());
+    for (size_t id = 0; id < remap.size(); ++id)
+        remap[id] = internTile(ds1.tileTable[id]);
+
+    const auto firstX = std::max(0, -originX);
+    const auto lastX = std::min(ds1Width, _width - originX);
+    const auto firstY = std::max(0, -originY);
+    const auto lastY = std::min(ds1Height, _height - originY);
+
+    const auto stampLayers = [&](const std::vector<DataTypes::DS1Layer> &source, std::vector<DataTypes::TileLayer> &target) {
+        for (size_t layerIdx = 0; layerIdx < source.size(); ++layerIdx) {
+            const auto &tiles = source[layerIdx].tiles;
+            auto &layer = target[layerIdx];
+            for (auto y = firstY; y < lastY; ++y) {
+                const auto *sourceRow = tiles.data() + y * ds1Width;
+                auto *targetRow = layer.data() + (originY + y) * _width + originX;
+                for (auto x = firstX; x < lastX; ++x)
+                    targetRow[x] = remap[sourceRow[x]];
             }
-
-            // Walls
-            for (auto layerIdx = 0; layerIdx < ds1.layers.wall.size(); ++layerIdx) {
-                const auto &tile = ds1.layers.wall[layerIdx][y * ds1Width + x];
-                const auto mapX = originX + x;
-                const auto mapY = originY + y;
-                if (mapX < 0 || mapX >= _width || mapY < 0 || mapY >= _height)
-                    continue;
-                _layers.wall[layerIdx][mapY * _width + mapX] = tile;
+        }
+    };
+
+    const auto stampSparseLayers = [&](const std::vector<DataTypes::DS1Layer> &source, std::vector<SparseTileLayer> &target) {
+        DataTypes::TileLayer row(std::max(lastX - firstX, 0));
+        for (size_t layerIdx = 0; layerIdx < source.size(); ++layerIdx) {
+            const auto &tiles = source[layerIdx].tiles;
+            for (auto y = firstY; y < lastY; ++y) {
+                const auto *sourceRow = tiles.data() + y * ds1Width;
+                for (auto x = firstX; x < lastX; ++x)
+                    row[x - firstX] = remap[sourceRow[x]];
+                target[layerIdx].writeRow(originY + y, originX + firstX, row);
             }
+        }
+    };
+
+    // Block copy all layers of the specific DS1 to the specified location on the map
+    stampLayers(ds1.layers.floor, _layers.floor);
+    stampSparseLayers(ds1.layers.wall, _layers.wall);
+    stampSparseLayers(ds1.layers.shadow, _layers.shadow);
+    stampSparseLayers(ds1.layers.substitution, _layers.substitution);
 
-            // Shadows
-            for (auto layerIdx = 0; layerIdx < ds1.layers.shadow.size(); ++layerIdx) {
-                const auto &tile = ds1.layers.shadow[layerIdx][y * ds1Width + x];
-                const auto mapX = originX + x;
-                const auto mapY = originY + y;
-                if (mapX < 0 || mapX >= _width || mapY < 0 || mapY >= _height)
-                    continue;
-                _layers.shadow[layerIdx][mapY * _width + mapX] = tile;
+    updateCollision(originX, originY, ds1Width, ds1Height);
+    markChunksDirty(originX, originY, ds1Width, ds1Height);
+}
+
+DataTypes::TileId MapEngine::internTile(const DataTypes::ResolvedTile &tile) {
+    if (tile.dt1Ref == nullptr)
+        return 0;
+
+    const auto [it, inserted] = _tileIds.try_emplace(tile, static_cast<DataTypes::TileId>(_tileTable.size()));
+    if (inserted)
+        _tileTable.push_back(tile);
+    return it->second;
+}
+
+void MapEngine::updateCollision(const int originX, const int originY, const int width, const int height) {
+    const auto addTile = [this](const int x, const int y, const DataTypes::ResolvedTile &tile, const uint32_t dt1Index) {
+        if (tile.dt1Ref && dt1Index < tile.dt1Ref->getTiles().size())
+            _collision.addTile(x, y, tile.dt1Ref->getTiles()[dt1Index].header);
+    };
+
+    for (auto y = std::max(originY, 0); y < std::min(originY + height, _height); ++y) {
+        for (auto x = std::max(originX, 0); x < std::min(originX + width, _width); ++x) {
+            _collision.clearTile(x, y);
+
+            for (const auto &layer : _layers.floor) {
+                const auto &tile = _tileTable[layer[y * _width + x]];
+                addTile(x, y, tile, tile.dt1Index);
             }
 
-            // Substitutions
-            for (auto layerIdx = 0; layerIdx < ds1.layers.substitution.size(); ++layerIdx) {
-                const auto &tile = ds1.layers.substitution[layerIdx][y * ds1Width + x];
-                const auto mapX = originX + x;
-                const auto mapY = originY + y;
-                if (mapX < 0 || mapX >= _width || mapY < 0 || mapY >= _height)
-                    continue;
-                _layers.substitution[layerIdx][mapY * _width + mapX] = tile;
+            for (const auto &layer : _layers.wall) {
+                const auto &tile = _tileTable[layer.get(x, y)];
+                addTile(x, y, tile, tile.dt1Index);
+                if (tile.type == DataTypes::TileType::RightPartOfNorthCornerWall)
+                    addTile(x, y, tile, tile.dt1IndexAlt);
             }
         }
     }
+}
+
+void MapEngine::prefetchTiles() {
+    // Substitution layers are never drawn, so their tiles are left for on-demand decoding.
+    std::vector<bool> used(_tileTable.size());
+    for (const auto &layer : _layers.floor) {
+        for (const auto id : layer)
+            used[id] = true;
+    }
+    for (const auto *layers : {&_layers.wall, &_layers.shadow}) {
+        for (const auto &layer : *layers) {
+            for (auto y = 0; y < _height; ++y)
+                layer.forEachInRow(y, [&used](int, const DataTypes::TileId id) { used[id] = true; });
+        }
+    }
 
+    absl::flat_hash_map<const DataTypes::DT1 *, std::vector<uint32_t>> referenced;
+    for (size_t id = 1; id < _tileTable.size(); ++id) {
+        if (!used[id])
+            continue;
+
+        const auto &tile = _tileTable[id];
+        auto &indices = referenced[tile.dt1Ref];
+        indices.push_back(tile.dt1Index);
+        if (tile.type == DataTypes::TileType::RightPartOfNorthCornerWall)
+            indices.push_back(tile.dt1IndexAlt);
+    }
+
+    auto &threadPool = AbyssEngine::getInstance().getThreadPool();
+    std::vector<std::future<void>> futures;
+    for (auto &dt1 : _dt1s) {
+        if (const auto it = referenced.find(&dt1); it != referenced.end())
+            futures.emplace_back(threadPool.submit([&dt1, &indices = it->second] { dt1.prefetch(indices); }));
+    }
+
+    std::exception_ptr error;
+    for (auto &future : futures) {
+        try {
+            threadPool.wait(future);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    if (error)
+        std::rethrow_exception(error);
+
+    for (auto &dt1 : _dt1s)
+        dt1.queueUpload();
+}
+
+MapEngine::VisibleCells MapEngine::getVisibleCells() const {
+    // A cell's screen column is (tileX - tileY) * 80 and its screen row (tileX + tileY) * 40, so bounding both diagonals by the view, widened
+    // by how far tiles reach past their cell, gives the cells that can draw anything on screen.
+    const auto above = _tileExtentAbove - RoofOffsetY;
+    const auto below = _tileExtentBelow + UpperWallOffsetY;
+
+    VisibleCells cells;
+    cells.minColumn = floorDiv(_cameraPosition.x - TileWidth, 80);
+    cells.maxColumn = floorDiv(_cameraPosition.x + ViewWidth, 80);
+    cells.minRow = floorDiv(_cameraPosition.y - below, 40);
+    cells.maxRow = floorDiv(_cameraPosition.y + ViewHeight + above, 40);
+    cells.firstY = std::max(0, floorDiv(cells.minRow - cells.maxColumn, 2));
+    cells.lastY = std::min(_height, floorDiv(cells.maxRow - cells.minColumn, 2) + 1);
+    return cells;
+}
+
+void MapEngine::VisibleCells::getColumns(const int tileY, const int width, int &firstX, int &lastX) const {
+    firstX = std::max({0, minColumn + tileY, minRow - tileY});
+    lastX = std::min({width, maxColumn + tileY + 1, maxRow - tileY + 1});
 }
 
 void MapEngine::render() const {
     const auto &renderer = AbyssEngine::getInstance().getRenderer();
 
+    AbyssEngine::getInstance().getSpriteBatch().flush();
     SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
     SDL_RenderClear(renderer);
 
-    for (int tileY = 0; tileY < _height; ++tileY) {
-        for (int tileX = 0; tileX < _width; ++tileX) {
+    // Only cells that can reach the view are visited, so the cost follows the view size rather than the map size.
+    const auto visible = getVisibleCells();
+
+    // Calls draw(tileX, tile) for the visible wall tiles of row tileY, cell by cell and layer by layer within a cell, so every pass keeps its
+    // per-cell draw order across layers. Only the occupancy words covering [firstX, lastX) are read, and each layer walks its packed ids
+    // from firstX on, so the cost follows the visible cells rather than the map width.
+    _wallCursors.resize(_layers.wall.size());
+    const auto forEachWall = [&](const int tileY, auto &&draw) {
+        int firstX;
+        int lastX;
+        visible.getColumns(tileY, _width, firstX, lastX);
+        if (firstX >= lastX)
+            return;
+
+        for (size_t layerIdx = 0; layerIdx < _layers.wall.size(); ++layerIdx)
+            _wallCursors[layerIdx] = _layers.wall[layerIdx].getRowIds(tileY, firstX);
+
+        for (auto word = firstX / 64; word <= (lastX - 1) / 64; ++word) {
+            // Columns of this word inside [firstX, lastX).
+            auto range = ~uint64_t{0};
+            if (word == firstX / 64)
+                range &= ~uint64_t{0} << (firstX % 64);
+            if (word == (lastX - 1) / 64 && lastX % 64 != 0)
+                range &= ~(~uint64_t{0} << (lastX % 64));
+
+            uint64_t occupied = 0;
+            for (const auto &layer : _layers.wall)
+                occupied |= layer.getOccupancy(tileY)[word];
+
+            for (auto bits = occupied & range; bits != 0; bits &= bits - 1) {
+                const auto bit = bits & (~bits + 1);
+                const auto tileX = word * 64 + std::countr_zero(bits);
+                for (size_t layerIdx = 0; layerIdx < _layers.wall.size(); ++layerIdx) {
+                    if ((_layers.wall[layerIdx].getOccupancy(tileY)[word] & bit) == 0)
+                        continue;
+                    if (const auto &tile = _tileTable[*_wallCursors[layerIdx]++]; tile.dt1Ref)
+                        draw(tileX, tile);
+                }
+            }
+        }
+    };
+
+    // Queues a tile drawn at map pixel position (x, y) on the draw list.
+    const auto queueTile = [this](const DrawLayer layer, const int depth, const DataTypes::ResolvedTile &tile, const uint32_t dt1Index, const int x,
+                                  const int y) {
+        SDL_Texture *texture;
+        SDL_Rect source;
+        SDL_Rect dest;
+        if (tile.dt1Ref->getTileSprite(x - _cameraPosition.x, y - _cameraPosition.y, dt1Index, texture, source, dest))
+            _drawList.add(layer, depth, texture, &source, dest);
+    };
+
+    // Draw floors and shadows
+    queueFloorChunks(visible);
+
+    // Walls and roofs are queued in a single sweep; the draw list puts lower walls under the floors, and upper walls, roofs and whatever
+    // else was queued for the frame in depth order.
+    for (int tileY = visible.firstY; tileY < visible.lastY; ++tileY) {
+        forEachWall(tileY, [&](const int tileX, const DataTypes::ResolvedTile &tile) {
             const auto posX = (tileX - tileY) * 80;
             const auto posY = (tileX + tileY) * 40;
 
             // Draw lower walls
-            for (const auto &layer : _layers.wall) {
-                if (const auto &tile = layer[tileX + tileY * _width];
-                    tile.dt1Ref && tile.type >= DataTypes::TileType::LowerWallsEquivalentToLeftWall)
-                    tile.dt1Ref->drawTile(posX - _cameraPosition.x, posY - _cameraPosition.y, tile.dt1Index);
-            }
+            if (tile.type >= DataTypes::TileType::LowerWallsEquivalentToLeftWall)
+                queueTile(DrawLayer::LowerWalls, posY, tile, tile.dt1Index, posX, posY);
 
-            // Draw floors
-            for (const auto &layer : _layers.floor) {
-                if (const auto &tile = layer[tileX + tileY * _width]; tile.dt1Ref)
-                    tile.dt1Ref->drawTile(posX - _cameraPosition.x, posY - _cameraPosition.y, tile.dt1Index);
-            }
-            // Draw shadows
-            for (const auto &layer : _layers.shadow) {
-                if (const auto &tile = layer[tileX + tileY * _width]; tile.dt1Ref)
-                    tile.dt1Ref->drawTile(posX - _cameraPosition.x, posY - _cameraPosition.y, tile.dt1Index);
+            // Draw upper
+            if ((tile.type >= DataTypes::TileType::LeftWall && tile.type <= DataTypes::TileType::RightWallWithDoor) ||
+                (tile.type >= DataTypes::TileType::PillarsColumnsAndStandaloneObjects && tile.type <= DataTypes::TileType::Tree)) {
+                queueTile(DrawLayer::Walls, posY, tile, tile.dt1Index, posX, posY + UpperWallOffsetY);
+
+                // Super special condition. This was fun to figure out :(
+                if (tile.type == DataTypes::TileType::RightPartOfNorthCornerWall)
+                    queueTile(DrawLayer::Walls, posY, tile, tile.dt1IndexAlt, posX, posY + UpperWallOffsetY);
             }
-        }
+
+            // Draw Roof
+            if (tile.type == DataTypes::TileType::Roof)
+                queueTile(DrawLayer::Roofs, posY, tile, tile.dt1Index, posX, posY + RoofOffsetY);
+        });
     }
 
-    for (int tileY = 0; tileY < _height; ++tileY) {
-        for (int tileX = 0; tileX < _width; ++tileX) {
-            const auto posX = (tileX - tileY) * 80;
-            const auto posY = (tileX + tileY) * 40;
+    _drawList.sort();
+    _drawList.draw();
+    _drawList.clear();
+}
 
-            // Draw upper
-            for (const auto &layer : _layers.wall) {
-                if (const auto &tile = layer[tileX + tileY * _width];
-                    tile.dt1Ref && ((tile.type >= DataTypes::TileType::LeftWall && tile.type <=
-                                     DataTypes::TileType::RightWallWithDoor) || (
-                                        tile.type >= DataTypes::TileType::PillarsColumnsAndStandaloneObjects && tile.type <=
-                                        DataTypes::TileType::Tree))) {
-                    tile.dt1Ref->drawTile(posX - _cameraPosition.x, posY - _cameraPosition.y + 96, tile.dt1Index);
-
-                    // Super special condition. This was fun to figure out :(
-                    if (tile.type == DataTypes::TileType::RightPartOfNorthCornerWall)
-                        tile.dt1Ref->drawTile(posX - _cameraPosition.x, posY - _cameraPosition.y + 96, tile.dt1IndexAlt);
-                }
+void MapEngine::markChunksDirty(const int originX, const int originY, const int width, const int height) {
+    const auto firstX = std::max(originX, 0);
+    const auto lastX = std::min(originX + width, _width);
+    const auto firstY = std::max(originY, 0);
+    const auto lastY = std::min(originY + height, _height);
+    if (firstX >= lastX || firstY >= lastY)
+        return;
+
+    for (auto chunkY = firstY / ChunkSize; chunkY <= (lastY - 1) / ChunkSize; ++chunkY) {
+        for (auto chunkX = firstX / ChunkSize; chunkX <= (lastX - 1) / ChunkSize; ++chunkX)
+            _floorChunks[chunkY * _chunksWide + chunkX].dirty = true;
+    }
+}
 
-            }
+void MapEngine::buildChunk(const int chunkX, const int chunkY) const {
+    auto &chunk = _floorChunks[chunkY * _chunksWide + chunkX];
+    chunk.dirty = false;
+
+    // Collect the chunk's tiles in draw order (per cell, floors then shadows) and the area they cover.
+    std::vector<std::pair<SDL_Point, const DataTypes::ResolvedTile *>> tiles;
+    auto left = std::numeric_limits<int>::max();
+    auto top = std::numeric_limits<int>::max();
+    auto right = std::numeric_limits<int>::min();
+    auto bottom = std::numeric_limits<int>::min();
+    const auto addTile = [&](const int x, const int y, const DataTypes::TileId id) {
+        const auto &tile = _tileTable[id];
+        if (!tile.dt1Ref || tile.dt1Index >= tile.dt1Ref->getTiles().size())
+            return;
+
+        const auto &layout = tile.dt1Ref->getTiles()[tile.dt1Index];
+        const SDL_Point position{(x - y) * 80, (x + y) * 40};
+        left = std::min(left, position.x);
+        right = std::max(right, position.x + layout.width);
+        top = std::min(top, position.y - layout.drawOffsetY);
+        bottom = std::max(bottom, position.y - layout.drawOffsetY + layout.height);
+        tiles.emplace_back(position, &tile);
+    };
+
+    for (auto y = chunkY * ChunkSize; y < std::min((chunkY + 1) * ChunkSize, _height); ++y) {
+        for (auto x = chunkX * ChunkSize; x < std::min((chunkX + 1) * ChunkSize, _width); ++x) {
+            for (const auto &layer : _layers.floor)
+                addTile(x, y, layer[x + y * _width]);
+            for (const auto &layer : _layers.shadow)
+                addTile(x, y, layer.get(x, y));
+        }
+    }
 
+    if (tiles.empty() || left >= right || top >= bottom) {
+        if (chunk.texture) {
+            chunk.texture.reset();
+            --_chunkTextureCount;
         }
+        chunk.bounds = {};
+        return;
     }
 
-    for (int tileY = 0; tileY < _height; ++tileY) {
-        for (int tileX = 0; tileX < _width; ++tileX) {
-            const auto posX = (tileX - tileY) * 80;
-            const auto posY = (tileX + tileY) * 40;
+    const SDL_Rect bounds{left, top, right - left, bottom - top};
+    const auto renderer = AbyssEngine::getInstance().getRenderer();
+    if (!chunk.texture || chunk.bounds.w != bounds.w || chunk.bounds.h != bounds.h) {
+        if (!chunk.texture) {
+            if (_chunkTextureCount >= MaxChunkTextures)
+                releaseOldestChunkTexture();
+            ++_chunkTextureCount;
+        }
+        chunk.texture.reset(Common::TextureTracker::createTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, bounds.w, bounds.h,
+                                                                  "MapEngine", absl::StrCat("floor chunk ", chunkX, ",", chunkY)));
+        SDL_SetTextureBlendMode(chunk.texture.get(), SDL_BLENDMODE_BLEND);
+    }
+    chunk.bounds = bounds;
 
-            // Draw Roof
-            for (const auto &layer : _layers.wall) {
-                if (const auto &tile = layer[tileX + tileY * _width];
-                    tile.dt1Ref && tile.type == DataTypes::TileType::Roof)
-                    tile.dt1Ref->drawTile(posX - _cameraPosition.x, posY - _cameraPosition.y - 72, tile.dt1Index);
-            }
+    auto &spriteBatch = AbyssEngine::getInstance().getSpriteBatch();
+    const auto oldTarget = SDL_GetRenderTarget(renderer);
+    spriteBatch.flush();
+    SDL_SetRenderTarget(renderer, chunk.texture.get());
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+    SDL_RenderClear(renderer);
+
+    for (const auto &[position, tile] : tiles) {
+        tile->dt1Ref->drawTile(position.x - bounds.x, position.y - bounds.y, tile->dt1Index);
+        // Tiles still waiting in the upload queue are skipped, so the chunk is built again once they are in.
+        if (tile->dt1Ref->isTilePending(tile->dt1Index))
+            chunk.dirty = true;
+    }
+
+    spriteBatch.flush();
+    SDL_SetRenderTarget(renderer, oldTarget);
+}
 
+void MapEngine::releaseOldestChunkTexture() const {
+    FloorChunk *oldest = nullptr;
+    for (auto &chunk : _floorChunks) {
+        if (chunk.texture && chunk.lastDrawnFrame < _frame && (!oldest || chunk.lastDrawnFrame < oldest->lastDrawnFrame))
+            oldest = &chunk;
+    }
+    if (oldest == nullptr)
+        return;
+
+    oldest->texture.reset();
+    oldest->dirty = true;
+    --_chunkTextureCount;
+}
+
+void MapEngine::queueFloorChunks(const VisibleCells &visible) const {
+    ++_frame;
+
+    std::vector<int> chunks;
+    for (int tileY = visible.firstY; tileY < visible.lastY; ++tileY) {
+        int firstX;
+        int lastX;
+        visible.getColumns(tileY, _width, firstX, lastX);
+        for (auto chunkX = firstX / ChunkSize; firstX < lastX && chunkX <= (lastX - 1) / ChunkSize; ++chunkX)
+            chunks.push_back(tileY / ChunkSize * _chunksWide + chunkX);
+    }
+    std::ranges::sort(chunks);
+    chunks.erase(std::ranges::unique(chunks).begin(), chunks.end());
+
+    // Mark every visible chunk first, so building one never releases the texture of another visible chunk.
+    for (const auto index : chunks)
+        _floorChunks[index].lastDrawnFrame = _frame;
+
+    // Chunks share one depth, so they keep this row-major order on the draw list.
+    for (const auto index : chunks) {
+        const auto &chunk = _floorChunks[index];
+        if (chunk.dirty)
+            buildChunk(index % _chunksWide, index / _chunksWide);
+        if (chunk.texture) {
+            const SDL_Rect dest{chunk.bounds.x - _cameraPosition.x, chunk.bounds.y - _cameraPosition.y, chunk.bounds.w, chunk.bounds.h};
+            _drawList.add(DrawLayer::Floors, 0, chunk.texture.get(), nullptr, dest);
         }
     }
 }
 
+void MapEngine::setPalette(const DataTypes::Palette &palette) {
+    for (auto &dt1 : _dt1s)
+        dt1.setPalette(palette);
+    for (auto &chunk : _floorChunks)
+        chunk.dirty = true;
+}
+
 void MapEngine::setCameraPosition(int x, int y) {
     _cameraPosition.x = x - 320;
     _cameraPosition.y = y - 260;
@@ -184,5 +559,116 @@ void MapEngine::getMapSize(int &width, int &height) const {
     height = _height;
 }
 
+const CollisionGrid &MapEngine::getCollisionGrid() const { return _collision; }
+
+DrawList &MapEngine::getDrawList() { return _drawList; }
+
+std::vector<std::byte> MapEngine::saveSnapshot() const {
+    std::vector<std::byte> out;
+
+    const SnapshotHeader header{
+        .width = _width,
+        .height = _height,
+        .dt1Count = static_cast<uint32_t>(_dt1s.size()),
+        .tileCount = static_cast<uint32_t>(_tileTable.size()),
+        .layerCounts = {static_cast<uint32_t>(_layers.floor.size()), static_cast<uint32_t>(_layers.wall.size()),
+                        static_cast<uint32_t>(_layers.shadow.size()), static_cast<uint32_t>(_layers.substitution.size())},
+    };
+    writeValues(out, std::span(&header, 1));
+
+    for (const auto &dt1 : _dt1s) {
+        const auto &path = dt1.getPath();
+        const auto hash = dt1.getSourceHash();
+        const auto length = static_cast<uint32_t>(path.size());
+        writeValues(out, std::span(&hash, 1));
+        writeValues(out, std::span(&length, 1));
+        writeValues(out, path);
+    }
+
+    std::vector<SnapshotTile> tiles;
+    tiles.reserve(_tileTable.size());
+    for (const auto &tile : _tileTable) {
+        const auto dt1 = tile.dt1Ref ? static_cast<uint32_t>(tile.dt1Ref - _dt1s.data()) : NoDt1;
+        tiles.push_back({dt1, tile.dt1Index, tile.dt1IndexAlt, static_cast<uint32_t>(tile.type)});
+    }
+    writeValues(out, tiles);
+
+    for (const auto &layer : _layers.floor)
+        writeValues(out, layer);
+    for (const auto *layers : {&_layers.wall, &_layers.shadow, &_layers.substitution}) {
+        for (const auto &layer : *layers)
+            writeSparseLayer(out, layer, _height);
+    }
+
+    for (const auto plane : CollisionPlanes)
+        writeValues(out, _collision.getPlane(plane));
+
+    return out;
+}
+
+std::unique_ptr<MapEngine> MapEngine::loadSnapshot(const std::span<const std::byte> snapshot, const DataTypes::Palette &palette) {
+    Streams::SpanReader sr(snapshot);
+
+    SnapshotHeader header;
+    readValues(sr, std::span(&header, 1));
+    if (header.width <= 0 || header.height <= 0 || header.tileCount == 0)
+        throw std::runtime_error("Malformed map snapshot");
+
+    std::vector<std::string> dt1Paths(header.dt1Count);
+    std::vector<uint64_t> dt1Hashes(header.dt1Count);
+    for (uint32_t i = 0; i < header.dt1Count; ++i) {
+        uint32_t length;
+        readValues(sr, std::span(&dt1Hashes[i], 1));
+        readValues(sr, std::span(&length, 1));
+        const auto path = sr.readSpan(length);
+        dt1Paths[i].assign(reinterpret_cast<const char *>(path.data()), path.size());
+    }
+
+    auto level = loadLevelFiles({}, dt1Paths, palette);
+    if (level.dt1s.size() != header.dt1Count)
+        throw std::runtime_error("Malformed map snapshot");
+    for (uint32_t i = 0; i < header.dt1Count; ++i) {
+        if (level.dt1s[i].getSourceHash() != dt1Hashes[i])
+            return nullptr;
+    }
+
+    auto map = std::make_unique<MapEngine>(header.width, header.height, std::move(level.dt1s), std::vector<DataTypes::DS1>{});
+
+    std::vector<SnapshotTile> tiles(header.tileCount);
+    readValues(sr, tiles);
+    map->_tileTable.assign(tiles.size(), DataTypes::ResolvedTile{});
+    for (size_t id = 0; id < tiles.size(); ++id) {
+        const auto &tile = tiles[id];
+        if (tile.dt1 == NoDt1)
+            continue;
+        if (tile.dt1 >= map->_dt1s.size() || tile.dt1Index >= map->_dt1s[tile.dt1].getTiles().size() ||
+            tile.dt1IndexAlt >= map->_dt1s[tile.dt1].getTiles().size())
+            throw std::runtime_error("Malformed map snapshot");
+
+        map->_tileTable[id] = {&map->_dt1s[tile.dt1], tile.dt1Index, tile.dt1IndexAlt, static_cast<DataTypes::TileType>(tile.type)};
+        map->_tileIds.try_emplace(map->_tileTable[id], static_cast<DataTypes::TileId>(id));
+    }
+
+    map->_layers.floor.assign(header.layerCounts[0], DataTypes::TileLayer(static_cast<size_t>(header.width) * header.height));
+    for (auto &layer : map->_layers.floor) {
+        readValues(sr, layer);
+        if (std::ranges::any_of(layer, [&](const DataTypes::TileId id) { return id >= header.tileCount; }))
+            throw std::runtime_error("Malformed map snapshot");
+    }
+
+    map->_layers.wall.assign(header.layerCounts[1], SparseTileLayer(header.width, header.height));
+    map->_layers.shadow.assign(header.layerCounts[2], SparseTileLayer(header.width, header.height));
+    map->_layers.substitution.assign(header.layerCounts[3], SparseTileLayer(header.width, header.height));
+    for (auto *layers : {&map->_layers.wall, &map->_layers.shadow, &map->_layers.substitution}) {
+        for (auto &layer : *layers)
+            readSparseLayer(sr, layer, header.width, header.height, header.tileCount);
+    }
+
+    for (const auto plane : CollisionPlanes)
+        readValues(sr, map->_collision.getPlane(plane));
+
+    return map;
+}
+
 
 } // namespace Abyss::MapEngine
@@ -2,7 +2,15 @@
 
 #include "Abyss/DataTypes/DS1.h"
 #include "Abyss/DataTypes/DT1.h"
+#include "Abyss/DataTypes/DT1TileIndex.h"
+#include "CollisionGrid.h"
+#include "DrawList.h"
+#include "SparseTileLayer.h"
 
+#include <absl/container/flat_hash_map.h>
+#include <cstddef>
+#include <memory>
+#include <span>
 #include <vector>
 #include <string>
 #include <SDL2/SDL.h>
@@ -14,21 +22,92 @@ class MapEngine {
     const int _height{};
     std::vector<DataTypes::DT1> _dt1s;
     std::vector<DataTypes::DS1> _ds1s;
+    DataTypes::DT1TileIndex _tileIndex;
+    CollisionGrid _collision;
     SDL_Point _cameraPosition{-320, -260};
 
+    // Every distinct tile placed on the map; layer cells are ids into it, 0 being empty.
+    std::vector<DataTypes::ResolvedTile> _tileTable{DataTypes::ResolvedTile{}};
+    absl::flat_hash_map<DataTypes::ResolvedTile, DataTypes::TileId> _tileIds;
+
+    // Floors cover nearly every cell and stay dense; the other layers are mostly empty.
     struct {
-        std::vector<DataTypes::TileMap> floor{};
-        std::vector<DataTypes::TileMap> wall{};
-        std::vector<DataTypes::TileMap> shadow{};
-        std::vector<DataTypes::TileMap> substitution{};
+        std::vector<DataTypes::TileLayer> floor{};
+        std::vector<SparseTileLayer> wall{};
+        std::vector<SparseTileLayer> shadow{};
+        std::vector<SparseTileLayer> substitution{};
     } _layers;
 
+    // Floors and shadows only change when a DS1 is stamped, so they are pre-rendered in chunks of ChunkSize x ChunkSize cells, each into a
+    // texture covering its tiles. Chunks are built when first visible and rebuilt when marked dirty; textures of chunks that went out of
+    // view are released once more than MaxChunkTextures exist.
+    static constexpr int ChunkSize = 8;
+    static constexpr int MaxChunkTextures = 32;
+
+    struct FloorChunk {
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture = {nullptr, Common::TextureTracker::destroy};
+        // Area covered by the texture, in map pixels (cell x, y is drawn at (x - y) * 80, (x + y) * 40).
+        SDL_Rect bounds{};
+        bool dirty{true};
+        uint64_t lastDrawnFrame{};
+    };
+
+    int _chunksWide{};
+    int _chunksHigh{};
+    mutable std::vector<FloorChunk> _floorChunks{};
+    mutable size_t _chunkTextureCount{};
+    mutable uint64_t _frame{};
+
+    // Rebuilt every frame by render(); see getDrawList().
+    mutable DrawList _drawList{};
+    // Per wall layer, the next packed id of the row render() is walking. Kept to avoid allocating every frame.
+    mutable std::vector<const DataTypes::TileId *> _wallCursors{};
+
+    // How far any DT1 tile reaches above and below the point it is drawn at, for culling.
+    int _tileExtentAbove{};
+    int _tileExtentBelow{};
+
+    // The cells render() visits: rows [firstY, lastY), each clipped to the columns whose tiles can reach the view.
+    struct VisibleCells {
+        int minColumn{};
+        int maxColumn{};
+        int minRow{};
+        int maxRow{};
+        int firstY{};
+        int lastY{};
+
+        void getColumns(int tileY, int width, int &firstX, int &lastX) const;
+    };
+
+    DataTypes::TileId internTile(const DataTypes::ResolvedTile &tile);
+    void markChunksDirty(int originX, int originY, int width, int height);
+    void buildChunk(int chunkX, int chunkY) const;
+    void releaseOldestChunkTexture() const;
+    void queueFloorChunks(const VisibleCells &visible) const;
+    [[nodiscard]] VisibleCells getVisibleCells() const;
+    void updateCollision(int originX, int originY, int width, int height);
+
 public:
+    // Bump when the snapshot layout changes.
+    static constexpr uint32_t SnapshotVersion = 1;
+
     MapEngine(int width, int height, std::vector<DataTypes::DT1> dt1s, std::vector<DataTypes::DS1> ds1s);
+    // Rebuilds a map saved with saveSnapshot(). Only the DT1s are loaded; the tile table, layers and collision grid are copied as they
+    // were saved. Returns null when one of the DT1s changed since the snapshot was taken, and throws if the snapshot is malformed. The
+    // result cannot stamp DS1s.
+    [[nodiscard]] static std::unique_ptr<MapEngine> loadSnapshot(std::span<const std::byte> snapshot, const DataTypes::Palette &palette);
+    // Serializes the assembled map: the DT1 manifest, the resolved tile table, every layer and the collision grid.
+    [[nodiscard]] std::vector<std::byte> saveSnapshot() const;
     void stampDs1(uint32_t ds1Index, int originX, int originY);
+    // Decodes every tile the stamped map references and queues the uploads. Tiles not prefetched are decoded when first drawn.
+    void prefetchTiles();
     void render() const;
+    void setPalette(const DataTypes::Palette &palette);
     void setCameraPosition(int x, int y);
     void getCameraPosition(int &x, int &y) const;
     void getMapSize(int &width, int &height) const;
+    [[nodiscard]] const CollisionGrid &getCollisionGrid() const;
+    // Drawables added here (units, objects, missiles) are drawn by the next render(), depth sorted together with the map's walls and roofs.
+    [[nodiscard]] DrawList &getDrawList();
 };
 } // namespace Abyss::MapEngine
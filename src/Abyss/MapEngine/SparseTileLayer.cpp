@@ -0,0 +1,73 @@
+#include "SparseTileLayer.h"
+
+#include <algorithm>
+
+namespace Abyss::MapEngine {
+
+SparseTileLayer::SparseTileLayer(const int width, const int height)
+    : _width(width), _height(height), _wordsPerRow((static_cast<size_t>(width) + 63) / 64), _occupancy(_wordsPerRow * height), _rows(height) {}
+
+DataTypes::TileId SparseTileLayer::get(const int x, const int y) const {
+    const auto occupancy = getOccupancy(y);
+    if ((occupancy[x / 64] & uint64_t{1} << (x % 64)) == 0)
+        return 0;
+
+    return _rows[y][countBefore(x, y)];
+}
+
+size_t SparseTileLayer::countBefore(const int x, const int y) const {
+    const auto occupancy = getOccupancy(y);
+    const auto word = static_cast<size_t>(x / 64);
+    size_t count = 0;
+    for (size_t i = 0; i < word; i++)
+        count += std::popcount(occupancy[i]);
+    if (word < occupancy.size())
+        count += std::popcount(occupancy[word] & ((uint64_t{1} << (x % 64)) - 1));
+    return count;
+}
+
+void SparseTileLayer::writeRow(const int y, const int x, const std::span<const DataTypes::TileId> values) {
+    // Rows are rebuilt whole; stamping writes long spans, so this is cheaper than inserting cell by cell.
+    std::vector<DataTypes::TileId> row(_width);
+    expandRow(y, row);
+    std::ranges::copy(values, row.begin() + x);
+
+    auto *occupancy = _occupancy.data() + static_cast<size_t>(y) * _wordsPerRow;
+    auto &ids = _rows[y];
+    std::fill_n(occupancy, _wordsPerRow, 0);
+    ids.clear();
+    for (auto column = 0; column < _width; column++) {
+        if (row[column] == 0)
+            continue;
+        occupancy[column / 64] |= uint64_t{1} << (column % 64);
+        ids.push_back(row[column]);
+    }
+    ids.shrink_to_fit();
+}
+
+void SparseTileLayer::expandRow(const int y, const std::span<DataTypes::TileId> row) const {
+    std::ranges::fill(row, 0);
+    forEachInRow(y, [&row](const int x, const DataTypes::TileId id) { row[x] = id; });
+}
+
+std::span<const uint64_t> SparseTileLayer::getOccupancy(const int y) const {
+    return {_occupancy.data() + static_cast<size_t>(y) * _wordsPerRow, _wordsPerRow};
+}
+
+const DataTypes::TileId *SparseTileLayer::getRowIds(const int y, const int x) const { return _rows[y].data() + countBefore(x, y); }
+
+size_t SparseTileLayer::getOccupiedCount() const {
+    size_t count = 0;
+    for (const auto &row : _rows)
+        count += row.size();
+    return count;
+}
+
+size_t SparseTileLayer::getMemoryUsage() const {
+    auto bytes = _occupancy.size() * sizeof(uint64_t) + _rows.size() * sizeof(std::vector<DataTypes::TileId>);
+    for (const auto &row : _rows)
+        bytes += row.capacity() * sizeof(DataTypes::TileId);
+    return bytes;
+}
+
+} // namespace Abyss::MapEngine
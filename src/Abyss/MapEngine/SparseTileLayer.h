@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Abyss/DataTypes/DS1.h"
+
+#include <bit>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace Abyss::MapEngine {
+
+// A map layer stored as a per-row occupancy bitmap plus the ids of the occupied cells, packed in column order. Wall, shadow and
+// substitution layers are mostly empty, so this is a fraction of a dense layer's size, and walking a row skips empty runs 64 cells at a
+// time.
+class SparseTileLayer {
+    int _width{};
+    int _height{};
+    size_t _wordsPerRow{};
+    std::vector<uint64_t> _occupancy{};
+    std::vector<std::vector<DataTypes::TileId>> _rows{};
+
+    // Number of occupied cells of row y left of column x, which is the position of the cell at x in the packed row.
+    [[nodiscard]] size_t countBefore(int x, int y) const;
+
+  public:
+    SparseTileLayer() = default;
+    SparseTileLayer(int width, int height);
+
+    [[nodiscard]] DataTypes::TileId get(int x, int y) const;
+    // Overwrites values.size() cells of row y starting at column x. Zero ids clear cells.
+    void writeRow(int y, int x, std::span<const DataTypes::TileId> values);
+    // Writes the whole row y into `row`, which must hold the layer width, with zeros for empty cells.
+    void expandRow(int y, std::span<DataTypes::TileId> row) const;
+    [[nodiscard]] std::span<const uint64_t> getOccupancy(int y) const;
+    // The packed ids of row y from column x on: one per occupied cell at or right of x, in column order.
+    [[nodiscard]] const DataTypes::TileId *getRowIds(int y, int x) const;
+    [[nodiscard]] size_t getOccupiedCount() const;
+    [[nodiscard]] size_t getMemoryUsage() const;
+
+    // Calls function(x, id) for every occupied cell of row y, left to right.
+    template <typename Function> void forEachInRow(const int y, Function &&function) const {
+        const auto occupancy = getOccupancy(y);
+        const auto *id = _rows[y].data();
+        for (size_t word = 0; word < occupancy.size(); word++) {
+            for (auto bits = occupancy[word]; bits != 0; bits &= bits - 1)
+                function(static_cast<int>(word * 64) + std::countr_zero(bits), *id++);
+        }
+    }
+};
+
+} // namespace Abyss::MapEngine
@@ -0,0 +1,58 @@
+#include "SpanReader.h"
+
+#include <algorithm>
+
+namespace Abyss::Streams {
+
+SpanReader::SpanReader(const std::span<const std::byte> data) : _data(data) {}
+
+uint8_t SpanReader::readUInt8() { return readUnsigned<uint8_t>(); }
+
+uint16_t SpanReader::readUInt16() { return readUnsigned<uint16_t>(); }
+
+int16_t SpanReader::readInt16() { return static_cast<int16_t>(readUInt16()); }
+
+uint32_t SpanReader::readUInt32() { return readUnsigned<uint32_t>(); }
+
+int32_t SpanReader::readInt32() { return static_cast<int32_t>(readUInt32()); }
+
+void SpanReader::readBytes(const std::span<std::byte> data) { std::ranges::copy(readSpan(data.size()), data.begin()); }
+
+void SpanReader::readBytes(const std::span<uint8_t> data) {
+    std::ranges::transform(readSpan(data.size()), data.begin(), [](const std::byte b) { return static_cast<uint8_t>(b); });
+}
+
+std::string SpanReader::readString() {
+    const auto rest = _data.subspan(_position);
+    const auto terminator = std::ranges::find(rest, std::byte{0});
+    if (terminator == rest.end())
+        throw std::runtime_error("Unterminated string");
+
+    std::string result(reinterpret_cast<const char *>(rest.data()), terminator - rest.begin());
+    _position += result.size() + 1;
+    return result;
+}
+
+std::span<const std::byte> SpanReader::readSpan(const size_t count) {
+    if (count > remaining())
+        throw std::runtime_error("Unexpected end of data");
+
+    const auto result = _data.subspan(_position, count);
+    _position += count;
+    return result;
+}
+
+void SpanReader::skip(const size_t numBytes) { seek(_position + numBytes); }
+
+void SpanReader::seek(const size_t position) {
+    if (position > _data.size())
+        throw std::runtime_error("Seek past end of data");
+
+    _position = position;
+}
+
+size_t SpanReader::getPosition() const { return _position; }
+
+size_t SpanReader::remaining() const { return _data.size() - _position; }
+
+} // namespace Abyss::Streams
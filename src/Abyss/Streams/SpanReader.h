@@ -0,0 +1,50 @@
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+
+namespace Abyss::Streams {
+
+// Little-endian reader over a buffer that is already in memory. Unlike StreamReader it can hand out views into the buffer, so parsers can
+// reference their payload instead of copying it.
+class SpanReader {
+    std::span<const std::byte> _data;
+    size_t _position{};
+
+  public:
+    explicit SpanReader(std::span<const std::byte> data);
+    [[nodiscard]] uint8_t readUInt8();
+    [[nodiscard]] uint16_t readUInt16();
+    [[nodiscard]] int16_t readInt16();
+    [[nodiscard]] uint32_t readUInt32();
+    [[nodiscard]] int32_t readInt32();
+    void readBytes(std::span<std::byte> data);
+    void readBytes(std::span<uint8_t> data);
+    // Reads a NUL-terminated string and advances past the terminator.
+    [[nodiscard]] std::string readString();
+
+    // Returns a view of the next `count` bytes and advances past them.
+    [[nodiscard]] std::span<const std::byte> readSpan(size_t count);
+
+    template <std::unsigned_integral T> T readUnsigned() {
+        const auto bytes = readSpan(sizeof(T));
+        T result = 0;
+
+        for (auto i = 0; i < static_cast<int>(sizeof(T)); i++) {
+            result |= static_cast<T>(bytes[i]) << (8 * i);
+        }
+
+        return result;
+    }
+
+    void skip(size_t numBytes);
+    void seek(size_t position);
+    [[nodiscard]] size_t getPosition() const;
+    [[nodiscard]] size_t remaining() const;
+};
+
+} // namespace Abyss::Streams
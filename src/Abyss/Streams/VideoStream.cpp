@@ -1,5 +1,6 @@
 #include "VideoStream.h"
 
+#include "Abyss/Common/TextureTracker.h"
 #include "Abyss/Singletons.h"
 #include <absl/strings/str_cat.h>
 
@@ -120,7 +121,7 @@ int64_t VideoStream::videoStreamSeek(const int64_t offset, const int whence) {
 }
 
 VideoStream::VideoStream(FileSystem::InputStream stream, std::optional<FileSystem::InputStream> separateAudio)
-    : _stream(std::move(stream)), _ringBuffer(1024 * 4096), _texture(nullptr, SDL_DestroyTexture), _videoCodecContext(), _audioCodecContext(), _avFrame(),
+    : _stream(std::move(stream)), _ringBuffer(1024 * 4096), _texture(nullptr, Common::TextureTracker::destroy), _videoCodecContext(), _audioCodecContext(), _avFrame(),
       _avBuffer(), _swsContext(), _sourceRect(), _targetRect(), _microsPerFrame(0), _videoTimestamp(0) {
     _avBuffer = static_cast<unsigned char *>(av_malloc(DecodeBufferSize)); // AVIO is going to free this automagically... because why not?
     memset(_avBuffer, 0, DecodeBufferSize);
@@ -208,8 +209,9 @@ VideoStream::VideoStream(FileSystem::InputStream stream, std::optional<FileSyste
     _targetRect = {.x = 0, .y = (600 / 2) - static_cast<int>(800 * ratio / 2), .w = 800, .h = static_cast<int>(800 * ratio)};
 
     //) = Engine::Get()->GetSystemIO().CreateTexture(ITexture::Format::YUV, _videoCodecContext->width, _videoCodecContext->height);
-    _texture.reset(SDL_CreateTexture(Abyss::Singletons::getRendererProvider().getRenderer(), SDL_PIXELFORMAT_IYUV, SDL_TEXTUREACCESS_STREAMING,
-                                     _videoCodecContext->width, _videoCodecContext->height));
+    _texture.reset(Common::TextureTracker::createTexture(Abyss::Singletons::getRendererProvider().getRenderer(), SDL_PIXELFORMAT_IYUV,
+                                                         SDL_TEXTUREACCESS_STREAMING, _videoCodecContext->width, _videoCodecContext->height, "VideoStream",
+                                                         "video"));
 
     _swsContext = sws_getContext(_videoCodecContext->width, _videoCodecContext->height, _videoCodecContext->pix_fmt, _videoCodecContext->width,
                                  _videoCodecContext->height, AV_PIX_FMT_YUV420P, SWS_POINT, nullptr, nullptr, nullptr);
@@ -262,6 +264,7 @@ void VideoStream::update(const uint32_t ticks) {
 void VideoStream::render() const {
     if (!_framesReady)
         return;
+    Common::TextureTracker::touch(_texture.get());
     SDL_RenderCopy(Singletons::getRendererProvider().getRenderer(), _texture.get(), &_sourceRect, &_targetRect);
 }
 
@@ -1,4 +1,5 @@
 #include "Label.h"
+#include "Abyss/Common/SpriteBatch.h"
 #include "Abyss/Singletons.h"
 
 namespace Abyss::UI {
@@ -59,18 +60,16 @@ void Label::draw(const int x, const int y) const {
     if (!_texture || _text.empty())
         return;
 
-    const auto renderer = Singletons::getRendererProvider().getRenderer();
     const SDL_Rect rect{x, y, _width, _height};
-    SDL_RenderCopy(renderer, _texture.get(), nullptr, &rect);
+    Singletons::getRendererProvider().getSpriteBatch().draw(_texture.get(), nullptr, rect);
 }
 
 void Label::drawCentered(const int x, const int y) const {
     if (!_texture || _text.empty())
         return;
 
-    const auto renderer = Singletons::getRendererProvider().getRenderer();
     const SDL_Rect rect{x - _width / 2, y - _height / 2, _width, _height};
-    SDL_RenderCopy(renderer, _texture.get(), nullptr, &rect);
+    Singletons::getRendererProvider().getSpriteBatch().draw(_texture.get(), nullptr, rect);
 }
 
 } // namespace Abyss::UI
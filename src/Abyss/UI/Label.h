@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Abyss/Common/TextureTracker.h"
 #include "Abyss/Concepts/FontRenderer.h"
 
 #include <SDL2/SDL.h>
@@ -10,7 +11,7 @@ namespace Abyss::UI {
 
 class Label {
     const Concepts::FontRenderer *_fontRenderer;
-    std::unique_ptr<SDL_Texture, void (*)(SDL_Texture *)> _texture = {nullptr, SDL_DestroyTexture};
+    std::unique_ptr<SDL_Texture, void (*)(SDL_Texture *)> _texture = {nullptr, Common::TextureTracker::destroy};
     std::string _text;
     SDL_Color _color = {255, 255, 255, 255};
     int _width = 0;
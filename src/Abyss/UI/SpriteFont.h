@@ -1,6 +1,8 @@
 #pragma once
 
 #include "Abyss/Common/Logging.h"
+#include "Abyss/Common/SpriteBatch.h"
+#include "Abyss/Common/TextureTracker.h"
 #include "Abyss/Concepts/Drawable.h"
 #include "Abyss/Concepts/FontRenderer.h"
 #include "Abyss/Singletons.h"
@@ -26,7 +28,7 @@ template <Concepts::Drawable T> class SpriteFont final : public Concepts::FontRe
     absl::flat_hash_map<int, Glyph> _glyphs;
 
     auto renderText(const std::string_view text, int &width, int &height) const -> std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> override {
-        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{nullptr, SDL_DestroyTexture};
+        std::unique_ptr<SDL_Texture, decltype(&SDL_DestroyTexture)> texture{nullptr, Common::TextureTracker::destroy};
         width = 0;
         height = 0;
 
@@ -39,9 +41,11 @@ template <Concepts::Drawable T> class SpriteFont final : public Concepts::FontRe
         }
 
         const auto renderer = Singletons::getRendererProvider().getRenderer();
-        texture.reset(SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height));
+        texture.reset(Common::TextureTracker::createTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height, "Label", text));
         SDL_SetTextureBlendMode(texture.get(), SDL_BLENDMODE_MUL);
+        auto &spriteBatch = Singletons::getRendererProvider().getSpriteBatch();
         const auto oldTarget = SDL_GetRenderTarget(renderer);
+        spriteBatch.flush();
         SDL_SetRenderTarget(renderer, texture.get());
 
         int drawX = 0;
@@ -53,6 +57,7 @@ template <Concepts::Drawable T> class SpriteFont final : public Concepts::FontRe
             drawX += glyphWidth + glyphOffsetX;
         }
 
+        spriteBatch.flush();
         SDL_SetRenderTarget(renderer, oldTarget);
 
         return std::move(texture);
@@ -1,5 +1,5 @@
 #pragma once
-#include "Abyss/DataTypes/DC6.h"
+#include "Abyss/Common/SpriteCache.h"
 #include "Abyss/UI/Button.h"
 #include "Abyss/UI/ButtonDef.h"
 #include "FontManager.h"
@@ -49,13 +49,13 @@ class ButtonDefManager {
 
 inline Abyss::UI::ButtonDef &GetButtonDef(const std::string_view name) { return ButtonDefManager::getInstance().getButtonDef(name); };
 
-inline Abyss::UI::Button<Abyss::DataTypes::DC6> CreateButton(const std::string_view buttonDefName, const std::string_view text,
-                                                             const std::function<void()> &onClick) {
+inline Abyss::UI::Button<Abyss::Common::CachedSprite> CreateButton(const std::string_view buttonDefName, const std::string_view text,
+                                                                   const std::function<void()> &onClick) {
     const auto &buttonDef = GetButtonDef(buttonDefName);
     const auto fontName = buttonDef.font;
     const auto &font = GetFont(fontName);
 
-    return Abyss::UI::Button<Abyss::DataTypes::DC6>(buttonDef, text, font, std::move(onClick));
+    return Abyss::UI::Button<Abyss::Common::CachedSprite>(buttonDef, text, font, std::move(onClick));
 };
 
 } // namespace OD2::Common
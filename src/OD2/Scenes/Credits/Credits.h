@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Abyss/Common/Scene.h"
-#include "Abyss/DataTypes/DC6.h"
+#include "Abyss/Common/SpriteCache.h"
 #include "OD2/Common/ButtonDefManager.h"
 #include "OD2/Common/PaletteManager.h"
 #include "OD2/Common/ResourcePaths.h"
@@ -27,8 +27,8 @@ class Credits final : public Abyss::Common::Scene {
     bool _doneWithCredits{};
     std::chrono::duration<double> _cycleTime{};
     int _cyclesUntilNextLine{};
-    Abyss::DataTypes::DC6 _background = Abyss::DataTypes::DC6(Common::ResourcePaths::Credits::CreditsBackground, Common::GetPalette("Sky"));
-    Abyss::UI::Button<Abyss::DataTypes::DC6> _btnSinglePlayer = Common::CreateButton("Medium", "EXIT", [this] { onExitClicked(); });
+    Abyss::Common::CachedSprite _background{Common::ResourcePaths::Credits::CreditsBackground, Common::GetPalette("Sky")};
+    Abyss::UI::Button<Abyss::Common::CachedSprite> _btnSinglePlayer = Common::CreateButton("Medium", "EXIT", [this] { onExitClicked(); });
     std::vector<std::string> _creditLines{};
     std::vector<CreditsLabelItem> _creditLabels{};
 
@@ -1,16 +1,16 @@
 #pragma once
 
-#include "Abyss/DataTypes/DC6.h"
+#include "Abyss/Common/SpriteCache.h"
 
 #include <chrono>
 
 namespace OD2::Scenes::MainMenu {
 
 class Logo {
-    Abyss::DataTypes::DC6Animation _logoLeftBlack;
-    Abyss::DataTypes::DC6Animation _logoLeft;
-    Abyss::DataTypes::DC6Animation _logoRightBlack;
-    Abyss::DataTypes::DC6Animation _logoRight;
+    Abyss::Common::CachedSpriteAnimation _logoLeftBlack;
+    Abyss::Common::CachedSpriteAnimation _logoLeft;
+    Abyss::Common::CachedSpriteAnimation _logoRightBlack;
+    Abyss::Common::CachedSpriteAnimation _logoRight;
 
   public:
     Logo();
@@ -2,7 +2,7 @@
 
 #include "Abyss/AbyssEngine.h"
 #include "Abyss/Common/Scene.h"
-#include "Abyss/DataTypes/DC6.h"
+#include "Abyss/Common/SpriteCache.h"
 #include "Abyss/UI/Button.h"
 #include "Logo.h"
 #include "OD2/Common/ButtonDefManager.h"
@@ -25,8 +25,8 @@ class MainMenu final : public Abyss::Common::Scene {
     ScreenMode _screenMode = ScreenMode::TradeMark;
     static int playedIntroVideos;
 
-    Abyss::DataTypes::DC6 _background = Abyss::DataTypes::DC6(Common::ResourcePaths::MainMenu::GameSelectScreen, Common::GetPalette("Sky"));
-    Abyss::DataTypes::DC6 _trademarkBackground = Abyss::DataTypes::DC6(Common::ResourcePaths::MainMenu::TrademarkScreen, Common::GetPalette("Sky"));
+    Abyss::Common::CachedSprite _background{Common::ResourcePaths::MainMenu::GameSelectScreen, Common::GetPalette("Sky")};
+    Abyss::Common::CachedSprite _trademarkBackground{Common::ResourcePaths::MainMenu::TrademarkScreen, Common::GetPalette("Sky")};
     Logo _d2Logo;
 
     Abyss::UI::Label _lblCredits = {Common::GetFont("fontformal10"),
@@ -39,12 +39,13 @@ class MainMenu final : public Abyss::Common::Scene {
     auto onExitClicked() -> void;
     void playMainThemeMusic();
 
-    Abyss::UI::Button<Abyss::DataTypes::DC6> _btnSinglePlayer = Common::CreateButton("Wide", "SINGLE PLAYER", [this] { onSinglePlayerClicked(); });
-    Abyss::UI::Button<Abyss::DataTypes::DC6> _btnMultiPlayer = Common::CreateButton("Wide", "MULTIPLAYER", [this] { onMultiplayerClicked(); });
-    Abyss::UI::Button<Abyss::DataTypes::DC6> _btnCredits = Common::CreateButton("Wide", "CREDITS", [this] { onCreditsClicked(); });
-    Abyss::UI::Button<Abyss::DataTypes::DC6> _btnMapTest =
+    Abyss::UI::Button<Abyss::Common::CachedSprite> _btnSinglePlayer =
+        Common::CreateButton("Wide", "SINGLE PLAYER", [this] { onSinglePlayerClicked(); });
+    Abyss::UI::Button<Abyss::Common::CachedSprite> _btnMultiPlayer = Common::CreateButton("Wide", "MULTIPLAYER", [this] { onMultiplayerClicked(); });
+    Abyss::UI::Button<Abyss::Common::CachedSprite> _btnCredits = Common::CreateButton("Wide", "CREDITS", [this] { onCreditsClicked(); });
+    Abyss::UI::Button<Abyss::Common::CachedSprite> _btnMapTest =
         Common::CreateButton("Wide", "MAP TEST", [] { Abyss::AbyssEngine::getInstance().setScene(std::make_unique<Scenes::MapTest::MapTest>()); });
-    Abyss::UI::Button<Abyss::DataTypes::DC6> _btnExit = Common::CreateButton("Wide", "EXIT DIABLO II", [this] { onExitClicked(); });
+    Abyss::UI::Button<Abyss::Common::CachedSprite> _btnExit = Common::CreateButton("Wide", "EXIT DIABLO II", [this] { onExitClicked(); });
 
   public:
     MainMenu();
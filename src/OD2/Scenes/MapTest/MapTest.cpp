@@ -2,13 +2,13 @@
 
 #include "Abyss/AbyssEngine.h"
 #include "Abyss/Common/Logging.h"
+#include "Abyss/MapEngine/LevelLoader.h"
 #include "OD2/Common/DataTableManager.h"
 #include "OD2/Common/PaletteManager.h"
 
 #include <imgui.h>
 #include <memory>
 #include <string>
-#include <absl/strings/str_replace.h>
 
 namespace OD2::Scenes::MapTest {
 
@@ -88,6 +88,17 @@ const Common::DataTableRow &MapTest::getLevelType(const int levelTypeId) {
 }
 
 void MapTest::update(std::chrono::duration<double> deltaTime) {
+    if (!_pendingMapEngine.valid() || _pendingMapEngine.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return;
+
+    onMapLoaded();
+
+    // The selection changed while the previous load was running; load what is selected now.
+    if (_reloadQueued) {
+        _reloadQueued = false;
+        if (!_selectedLevelAltName.empty())
+            loadTile(_selectedLevelAltName);
+    }
 }
 
 void MapTest::processEvent(const SDL_Event &event) {
@@ -95,6 +106,9 @@ void MapTest::processEvent(const SDL_Event &event) {
     case SDL_MOUSEBUTTONDOWN:
         switch (event.button.button) {
         case SDL_BUTTON_RIGHT:
+            // The map is built in the background, so there is nothing to drag until it arrives.
+            if (!_mapEngine)
+                break;
             _isMouseDragging = true;
             int mx;
             int my;
@@ -115,7 +129,7 @@ void MapTest::processEvent(const SDL_Event &event) {
         }
         break;
     case SDL_MOUSEMOTION:
-        if (_isMouseDragging) {
+        if (_isMouseDragging && _mapEngine) {
             // Drag but take scale into account
             int mx;
             int my;
@@ -128,7 +142,14 @@ void MapTest::processEvent(const SDL_Event &event) {
 }
 
 void MapTest::loadTile(const std::string &altName) {
+    // Only one load runs at a time. A selection made meanwhile is loaded once the running one finishes.
+    if (_pendingMapEngine.valid()) {
+        _reloadQueued = true;
+        return;
+    }
+
     Abyss::Common::Log::debug("Loading level alt: {}", altName);
+    _pendingLevelAltName = altName;
     const auto &levelPrest = getLevelPrest(_selectedLevelName);
     const auto levelId = std::stoi(levelPrest.at("LevelId"));
     const auto &levelDetails = getLevelDetails(levelId);
@@ -136,7 +157,8 @@ void MapTest::loadTile(const std::string &altName) {
     //const auto act = std::stoi(levelDetails.at("Act")) + 1;
     const auto act = std::stoi(_selectedLevelName.substr(4, 1));
     const auto &levelType = getLevelType(levelTypeId);
-    const auto &palette = Common::PaletteManager::getInstance().getPalette("Act" + std::to_string(act));
+    _selectedPaletteName = "Act" + std::to_string(act);
+    const auto &palette = Common::PaletteManager::getInstance().getPalette(_selectedPaletteName);
 
     std::vector<std::string> dt1sToLoad{};
 
@@ -151,37 +173,25 @@ void MapTest::loadTile(const std::string &altName) {
         }
     }
 
-    Abyss::DataTypes::DS1 ds1("/data/global/tiles/" + altName);
-
-    // Add all the DS1 files to the DT1s
-    for (auto &file : ds1.files) {
-        std::ranges::replace(file, '\\', '/');
-        if (file.starts_with("/d2/")) // Because why not?
-            file = file.substr(3);
-        std::ranges::transform(file, file.begin(), [](const auto c) { return std::tolower(c); });
-        if (std::ranges::find(dt1sToLoad, file) == dt1sToLoad.end()) {
-            absl::StrReplaceAll({{".tg1", ".dt1"}}, &file); // Replace tg1 with dt1 because blizzard
-            absl::StrReplaceAll({{".ds1", ".dt1"}}, &file); // Why yes, this is also a thing....
-            // remove  /d2 if it starts with it
-            if (file.starts_with("/d2/"))
-                file = file.substr(3);
-
-            dt1sToLoad.push_back(file);
-        }
-    }
-
-    const auto dsSubIndex = std::ranges::find(_mapAltSelections, altName) - _mapAltSelections.begin();
-    // Load all dt1s into a vector
-    std::vector<Abyss::DataTypes::DT1> dt1s{};
-    dt1s.reserve(dt1sToLoad.size());
-    for (const auto &dt1 : dt1sToLoad)
-        dt1s.emplace_back(dt1, palette);
+    // Parse the DS1 and load the level type's DT1s together with the ones the DS1 lists, on the loader pool. Only the tiles the stamped map
+    // references are then decoded, and their textures are uploaded over the next frames through the upload queue. loadLevel() restores a
+    // snapshot of the assembled map when it has one, which skips the parse, bind and stamp steps.
+    auto &threadPool = Abyss::AbyssEngine::getInstance().getThreadPool();
+    _pendingMapEngine = threadPool.submit(
+        [dt1sToLoad, palette, ds1Path = "/data/global/tiles/" + altName] { return Abyss::MapEngine::loadLevel(ds1Path, dt1sToLoad, palette); });
+}
 
-    const auto mapWidth = ds1.width;
-    const auto mapHeight = ds1.height;
+void MapTest::onMapLoaded() {
+    try {
+        _mapEngine = _pendingMapEngine.get();
+    } catch (const std::exception &exception) {
+        Abyss::Common::Log::error("Failed to load level {}: {}", _pendingLevelAltName, exception.what());
+        return;
+    }
 
-    _mapEngine = std::make_unique<Abyss::MapEngine::MapEngine>(mapWidth, mapHeight, std::move(dt1s), std::vector{std::move(ds1)});
-    _mapEngine->stampDs1(0, 0, 0);
+    int mapWidth;
+    int mapHeight;
+    _mapEngine->getMapSize(mapWidth, mapHeight);
 
     // Center the map
     const auto mapCenterX = mapWidth / 2;
@@ -242,6 +252,23 @@ void MapTest::render() {
         }
     }
 
+    // Palette selection. Tiles keep their indexed pixels, so switching only re-expands them.
+    if (_mapEngine && ImGui::BeginCombo("Palette", _selectedPaletteName.c_str())) {
+        for (int act = 1; act <= 5; ++act) {
+            const auto paletteName = "Act" + std::to_string(act);
+            const bool isSelected = (_selectedPaletteName == paletteName);
+            if (ImGui::Selectable(paletteName.c_str(), isSelected))
+                if (_selectedPaletteName != paletteName) {
+                    _selectedPaletteName = paletteName;
+                    _mapEngine->setPalette(Common::PaletteManager::getInstance().getPalette(paletteName));
+                }
+
+            if (isSelected)
+                ImGui::SetItemDefaultFocus();
+        }
+        ImGui::EndCombo();
+    }
+
     ImGui::Separator();
 
     // Show map information
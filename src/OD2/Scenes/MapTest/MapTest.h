@@ -4,6 +4,7 @@
 #include "Abyss/MapEngine/MapEngine.h"
 #include "OD2/Common/DataTableManager.h"
 
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,13 +16,18 @@ class MapTest final : public Abyss::Common::Scene {
     std::vector<std::string> _mapAltSelections{};
     std::string _selectedLevelName{};
     std::string _selectedLevelAltName{};
+    std::string _selectedPaletteName{};
     SDL_Point _mousePressedPosition{0, 0};
     SDL_Point _startCameraPosition{0, 0};
     bool _isMouseDragging{false};
     std::unique_ptr<Abyss::MapEngine::MapEngine> _mapEngine;
+    std::future<std::unique_ptr<Abyss::MapEngine::MapEngine>> _pendingMapEngine;
+    std::string _pendingLevelAltName{};
+    bool _reloadQueued{false};
     int _mapWidth;
 
     void onLevelChanged(const std::string &levelName);
+    void onMapLoaded();
     static const Common::DataTableRow &getLevelPrest(std::string_view name);
     static const Common::DataTableRow &getLevelDetails(int levelId);
     static const Common::DataTableRow &getLevelType(int levelTypeId);
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdlib>
+#include <iostream>
+
+// Aborts the test with the failing expression and its location.
+#define CHECK(condition)                                                                                                                     \
+    do {                                                                                                                                     \
+        if (!(condition)) {                                                                                                                  \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": CHECK(" #condition ") failed" << std::endl;                                       \
+            std::exit(EXIT_FAILURE);                                                                                                         \
+        }                                                                                                                                    \
+    } while (false)
@@ -0,0 +1,108 @@
+#include "Check.h"
+#include "TestProviders.h"
+
+#include "Abyss/Common/SpriteCache.h"
+#include "Abyss/DataTypes/Palette.h"
+#include "Abyss/Singletons.h"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+using namespace Abyss;
+
+namespace {
+
+constexpr auto PalettePath = "/data/global/palette/test/pal.dat";
+constexpr auto SpritePath = "/data/global/ui/test.dc6";
+
+void appendUInt32(std::string &data, const uint32_t value) {
+    for (auto shift = 0; shift < 32; shift += 8)
+        data.push_back(static_cast<char>(value >> shift & 0xFF));
+}
+
+// A DC6 with `directions` directions of one opaque 2x2 frame each.
+std::string makeSprite(const uint32_t directions) {
+    const std::string frameData = {'\x02', '\x01', '\x01', '\x80', '\x02', '\x01', '\x01', '\x80'};
+    constexpr uint32_t headerSize = 24;
+    constexpr uint32_t frameHeaderSize = 32;
+    constexpr uint32_t terminatorSize = 3;
+
+    std::string data;
+    appendUInt32(data, 6);
+    appendUInt32(data, 1);
+    appendUInt32(data, 0);
+    data.append(4, '\xEE');
+    appendUInt32(data, directions);
+    appendUInt32(data, 1);
+
+    const auto framesStart = headerSize + directions * 4;
+    const auto frameSize = frameHeaderSize + static_cast<uint32_t>(frameData.size()) + terminatorSize;
+    for (uint32_t i = 0; i < directions; i++)
+        appendUInt32(data, framesStart + i * frameSize);
+
+    for (uint32_t i = 0; i < directions; i++) {
+        appendUInt32(data, 0);
+        appendUInt32(data, 2);
+        appendUInt32(data, 2);
+        appendUInt32(data, 0);
+        appendUInt32(data, 0);
+        appendUInt32(data, 0);
+        appendUInt32(data, framesStart + (i + 1) * frameSize);
+        appendUInt32(data, static_cast<uint32_t>(frameData.size()));
+        data += frameData;
+        data.append(terminatorSize, '\xEE');
+    }
+
+    return data;
+}
+
+} // namespace
+
+int main() {
+    Tests::MemoryFileLoader files;
+    files.add(PalettePath, std::string(256 * 3, '\x40'));
+    files.add(SpritePath, makeSprite(2));
+    Tests::SoftwareRendererProvider renderer(64, 64);
+    Singletons::setFileProvider(&files);
+    Singletons::setRendererProvider(&renderer);
+
+    {
+        const DataTypes::Palette palette(PalettePath, "test");
+        Common::SpriteCache cache;
+        cache.setIdleTime(std::chrono::hours(1));
+
+        const auto sprite = cache.acquire(SpritePath, palette, Enums::BlendMode::Blend);
+        CHECK(!sprite->isDirectionDecoded(0));
+        CHECK(!sprite->isDirectionDecoded(1));
+
+        sprite->prefetch(0);
+        sprite->prefetch(1);
+        cache.collect();
+        CHECK(sprite->isDirectionDecoded(0));
+        CHECK(sprite->isDirectionDecoded(1));
+
+        // Direction 0 goes idle while direction 1 keeps being drawn.
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        sprite->prefetch(1);
+        cache.setIdleTime(std::chrono::milliseconds(100));
+        cache.collect();
+        CHECK(!sprite->isDirectionDecoded(0));
+        CHECK(sprite->isDirectionDecoded(1));
+
+        // An evicted direction is decoded again on its next use.
+        sprite->prefetch(0);
+        CHECK(sprite->isDirectionDecoded(0));
+
+        cache.setIdleTime(std::chrono::steady_clock::duration::zero());
+        cache.collect();
+        CHECK(!sprite->isDirectionDecoded(0));
+        CHECK(!sprite->isDirectionDecoded(1));
+        CHECK(cache.size() == 1);
+    }
+
+    Singletons::setRendererProvider(nullptr);
+    Singletons::setFileProvider(nullptr);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#include "Check.h"
+
+#include "Abyss/Common/PixelKernels.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+using namespace Abyss::Common;
+
+int main() {
+    std::array<uint32_t, 256> lookup{};
+    for (size_t i = 0; i < lookup.size(); i++)
+        lookup[i] = static_cast<uint32_t>(i * 0x01010101u) ^ 0xA5000000u ^ static_cast<uint32_t>(i) << 3;
+
+    constexpr size_t SampleSize = 1024 + 13;
+    std::vector<uint8_t> indices(SampleSize);
+    std::vector<uint8_t> mask(SampleSize);
+    for (size_t i = 0; i < SampleSize; i++) {
+        indices[i] = static_cast<uint8_t>(i * 7 + (i >> 8));
+        // Runs of transparent pixels long enough to hit the all-transparent fast paths, mixed with scattered ones and opaque bytes other
+        // than 0xFF.
+        mask[i] = (i / 32) % 3 == 0 || i % 5 == 0 ? 0 : static_cast<uint8_t>(1 + i % 3);
+    }
+
+    const auto kernels = PixelKernels::getSupportedKernels();
+    CHECK(!kernels.empty());
+    CHECK(kernels.front().name == "Generic");
+    CHECK(PixelKernels::getKernelName() == kernels.back().name);
+
+    // Lengths that cover an empty span, only the scalar tail, whole vectors, and vectors followed by a tail.
+    const std::array<size_t, 6> counts{0, 7, 16, 40, 1024, SampleSize};
+    for (const auto &kernel : kernels) {
+        for (const auto *maskData : {static_cast<const uint8_t *>(nullptr), static_cast<const uint8_t *>(mask.data())}) {
+            for (const auto count : counts) {
+                // One texel past the end checks that the kernel does not write outside the span.
+                std::vector<uint32_t> expected(SampleSize + 1, 0xDEADBEEF);
+                std::vector<uint32_t> actual(SampleSize + 1, 0xDEADBEEF);
+                kernels.front().expand(indices.data(), maskData, expected.data(), count, lookup.data());
+                kernel.expand(indices.data(), maskData, actual.data(), count, lookup.data());
+                CHECK(actual == expected);
+            }
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,33 @@
+#include "Check.h"
+
+#include "Abyss/MapEngine/SparseTileLayer.h"
+
+#include <vector>
+
+using namespace Abyss;
+
+int main() {
+    // Wider than two occupancy words, with cells on and next to the word boundaries.
+    constexpr int Width = 150;
+    MapEngine::SparseTileLayer layer(Width, 2);
+    std::vector<DataTypes::TileId> row(Width);
+    for (int x = 0; x < Width; x++)
+        row[x] = x % 3 == 0 || x == 63 || x == 64 || x == 127 ? static_cast<DataTypes::TileId>(x + 1) : 0;
+    layer.writeRow(1, 0, row);
+
+    for (int x = 0; x < Width; x++)
+        CHECK(layer.get(x, 1) == row[x]);
+
+    // Walking the packed ids from any start column visits the occupied cells from there on, in order.
+    for (int firstX = 0; firstX < Width; firstX++) {
+        const auto *id = layer.getRowIds(1, firstX);
+        for (int x = firstX; x < Width; x++) {
+            if (row[x] != 0)
+                CHECK(*id++ == row[x]);
+        }
+    }
+
+    CHECK(layer.get(10, 0) == 0);
+    CHECK(layer.getRowIds(0, 10) == layer.getRowIds(0, 0));
+    return 0;
+}
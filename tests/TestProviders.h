@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Abyss/Common/RendererProvider.h"
+#include "Abyss/Common/SpriteBatch.h"
+#include "Abyss/Common/SpriteCache.h"
+#include "Abyss/FileSystem/FileLoader.h"
+
+#include <SDL2/SDL.h>
+#include <absl/container/flat_hash_map.h>
+#include <absl/strings/str_cat.h>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace Abyss::Tests {
+
+// Serves files added with add() from memory.
+class MemoryFileLoader final : public FileSystem::FileLoader {
+    absl::flat_hash_map<std::string, std::string> _files{};
+
+  public:
+    void add(const std::string_view path, std::string data) { _files[path] = std::move(data); }
+
+    [[nodiscard]] FileSystem::InputStream loadFile(const std::string_view path) override {
+        const auto it = _files.find(path);
+        if (it == _files.end())
+            throw std::runtime_error(absl::StrCat("File not found: ", path));
+
+        return FileSystem::InputStream(std::make_unique<std::stringbuf>(it->second, std::ios::in));
+    }
+
+    [[nodiscard]] bool fileExists(const std::string_view path) override { return _files.contains(path); }
+};
+
+// Renders into an offscreen surface, so tests that create textures do not need a window or a video driver.
+class SoftwareRendererProvider final : public Common::RendererProvider {
+    std::unique_ptr<SDL_Surface, decltype(&SDL_FreeSurface)> _surface;
+    std::unique_ptr<SDL_Renderer, decltype(&SDL_DestroyRenderer)> _renderer;
+    Common::SpriteBatch _spriteBatch;
+    Common::SpriteCache _spriteCache{};
+
+  public:
+    SoftwareRendererProvider(const int width, const int height)
+        : _surface(SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888), SDL_FreeSurface),
+          _renderer(SDL_CreateSoftwareRenderer(_surface.get()), SDL_DestroyRenderer), _spriteBatch(_renderer.get()) {
+        if (!_renderer)
+            throw std::runtime_error(SDL_GetError());
+    }
+
+    [[nodiscard]] auto getRenderer() -> SDL_Renderer * override { return _renderer.get(); }
+    [[nodiscard]] auto getSpriteBatch() -> Common::SpriteBatch & override { return _spriteBatch; }
+    [[nodiscard]] auto getSpriteCache() -> Common::SpriteCache & override { return _spriteCache; }
+};
+
+} // namespace Abyss::Tests